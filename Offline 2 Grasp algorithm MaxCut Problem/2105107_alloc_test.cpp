@@ -0,0 +1,91 @@
+#include "2105107_maxcut.hpp"
+#include "2105107_vns.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+// Checks that a GRASP iteration allocates nothing once its MaxCutWorkspace is warmed up.
+// Global operator new is replaced by a counting version; each case warms a workspace with one
+// GRASP run, then runs GRASP again on it and requires the count not to move.
+
+atomic<long long> allocations{0};
+
+// The replacements pair malloc with free; GCC's check assumes the built-in new and delete
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    allocations++;
+    return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+const int warmIterations = 20;
+const int measuredIterations = 50;
+const double alpha = 0.75;
+
+// Allocations made by GRASP on a warmed workspace, with improve as the improvement phase
+long long measure(const Graph& g, function<void(MaxCutWorkspace&, mt19937&)> improve, bool deterministic, int& iterationsRun) {
+    MaxCutWorkspace ws(g);
+    mt19937 rng(1);
+    auto phase = [&](MaxCutWorkspace& w) { improve(w, rng); };
+    // Sized for the measured run, so visited does not have to grow
+    GRASP(ws, measuredIterations, alpha, rng, phase, deterministic, warmIterations);
+    long long before = allocations.load();
+    GRASPStats stats = GRASP(ws, measuredIterations, alpha, rng, phase, deterministic, measuredIterations);
+    iterationsRun = stats.iterations;
+    return allocations.load() - before;
+}
+
+// Usage: alloc_test [graph numbers...]; exits 1 if any warmed GRASP run allocated, 2 if a graph cannot be read
+int main(int argc, char* argv[]) {
+    vector<int> graphNums = {1, 11, 22, 43, 48};
+    if (argc > 1) {
+        graphNums.clear();
+        for (int i = 1; i < argc; i++) graphNums.push_back(atoi(argv[i]));
+    }
+
+    int failures = 0;
+    for (int graphNum : graphNums) {
+        Graph g(1);
+        try {
+            g = readGraphFromFile("graph_GRASP/set1/g" + to_string(graphNum) + ".rud");
+        } catch (const runtime_error& e) {
+            cerr << e.what() << endl;
+            return 2;
+        }
+        VariableNeighbourhoodSearch vns(g);
+        struct Phase {
+            string name;
+            function<void(MaxCutWorkspace&, mt19937&)> improve;
+            bool deterministic;
+        };
+        vector<Phase> phases = {
+            {"local search", [](MaxCutWorkspace& ws, mt19937&) { localSearch(ws); }, true},
+            {"vns", [&](MaxCutWorkspace& ws, mt19937& rng) { vns.improve(ws, rng); }, false},
+        };
+        for (auto& [name, improve, deterministic] : phases) {
+            int iterations = 0;
+            long long count = measure(g, improve, deterministic, iterations);
+            cout << "G" << graphNum << " " << name << ": " << count << " allocations in " << iterations << " iterations"
+                 << (count == 0 ? "" : "  FAIL") << endl;
+            if (count != 0) failures++;
+        }
+    }
+    if (failures > 0) {
+        cout << failures << " case(s) allocated after warm-up" << endl;
+        return 1;
+    }
+    cout << "No allocations after warm-up" << endl;
+    return 0;
+}
@@ -1,4 +1,9 @@
 #include "2105107_maxcut.hpp"  // Include the header for graph and algorithm definitions
+#include "2105107_spectral.hpp"
+#include "2105107_exact.hpp"
+#include "2105107_thread_pool.hpp"
+#include "2105107_memory.hpp"
+#include "2105107_known_best.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,62 +12,11 @@
 #include <ctime>
 #include <chrono>
 #include <iomanip>  // For setw to format the output
+#include <memory>
 
 
 using namespace std;
 
-// Function to read the graph from a .rud file
-Graph readGraphFromFile(const string& filename) {
-    ifstream file(filename);
-    int V, E;
-    file >> V >> E;
-
-    Graph g(V);
-    for (int i = 0; i < E; i++) {
-        int u, v, weight;
-        file >> u >> v >> weight;
-        g.addEdge(u, v, weight);
-    }
-    return g;
-}
-
-
-
-//hardcode known best
-int giveKnownbest(int graphNum) {
-    switch (graphNum) {
-    //     unordered_map<string, int> knownBest = {
-    // {"G1", 12078}, {"G2", 12084}, {"G3", 12077}, {"G11", 627}, {"G12", 621}, {"G13", 645}, {"G14", 3187}, {"G15", 3169}, {"G16", 3172}, {"G22", 14123}, {"G23", 14129}, {"G24", 14131}, {"G32", 1560}, {"G33", 1537}, {"G34", 1541}, {"G35", 8000}, {"G36", 7996}, {"G37", 8009}, {"G43", 7027}, {"G44", 7022}, {"G45", 7020}, {"G48", 6000}, {"G49", 6000}, {"G50", 5988}};
-        case 1: return 12078;
-        case 2: return 12084;
-        case 3: return 12077;
-        case 11: return 627;
-        //complete all
-        case 12: return 621;
-        case 13: return 645;
-        case 14: return 3187;
-        case 15: return 3169;
-        case 16: return 3172;
-        case 22: return 14123;
-        case 23: return 14129;
-        case 24: return 14131;
-        case 32: return 1560;
-        case 33: return 1537;
-        case 34: return 1541;
-        case 35: return 8000;
-        case 36: return 7996;
-        case 37: return 8009;
-        case 43: return 7027;
-        case 44: return 7022;
-        case 45: return 7020;
-        case 48: return 6000;
-        case 49: return 6000;
-        case 50: return 5988;
-        default: return -1;  // Unknown graph number
-
-    }
-}
-
 // Function to run all algorithms for a given graph
 void runAlgorithmsAndStoreResults(Graph& g, int graphNum, double alpha, ofstream& csvFile) {
     // Run Randomized Max-Cut
@@ -81,23 +35,60 @@ void runAlgorithmsAndStoreResults(Graph& g, int graphNum, double alpha, ofstream
     auto [SX_final, SY_final] = partition;
     int localSearchResult = computeCutWeight(g, SX_final, SY_final);
 
-    // Run GRASP Max-Cut
+    // Run Spectral Max-Cut, improved by local search
+    mt19937 spectralRng(rand());
+    SpectralResult spectral = spectralMaxCut(g, spectralRng);
+    auto [spectralPartition, spectralIterations] = localSearchMaxCut(g, spectral.X, spectral.Y);
+    int spectralResult = computeCutWeight(g, spectralPartition.first, spectralPartition.second);
+
+    // Run GRASP Max-Cut, unseeded so Best Value stays comparable with earlier runs
     int max_iterations = 50;  // Number of iterations for GRASP
-    auto [GRASP_X, GRASP_Y] = GRASP(g, max_iterations, alpha);  // 50 iterations for GRASP
+    GRASPStats graspStats;
+    auto [GRASP_X, GRASP_Y] = GRASP(g, max_iterations, alpha, 10, nullptr, &graspStats);  // 50 iterations for GRASP
     int graspResult = computeCutWeight(g, GRASP_X, GRASP_Y);
 
+    // And again seeded with the spectral + local search partition, in its own column
+    auto [seededX, seededY] = GRASP(g, max_iterations, alpha, 10, &spectralPartition);
+    int seededGraspResult = computeCutWeight(g, seededX, seededY);
+
+    // Known best: the published value, or for small graphs a proven optimum from branch and bound
+    long long knownBest = giveKnownbest(graphNum);
+    ExactResult exact;
+    if (knownBest < 0 && g.V <= maxExactVertices) {
+        vector<signed char> graspSide(g.V + 1, -1);
+        setsToSide(GRASP_X, GRASP_Y, graspSide);
+        exact = exactMaxCut(g, 60, &graspSide);
+        if (exact.proven) knownBest = exact.cut;
+    }
+
+    // Memory: the graph as loaded and with packed neighbour lists, then the peak since loading
+    size_t graphBytes = g.bytes();
+    size_t packedBytes = g.packNeighbours() ? g.bytes() : graphBytes;
+    g.unpackNeighbours();
+    size_t peakRSS = peakRSSBytes();
+
     // Prepare the result row and write to CSV
     csvFile << "G" << graphNum << "  ,";
     csvFile << g.V << "  ,";  // Number of vertices
-    csvFile << g.edges.size() << "  ,";  // Number of edges
+    csvFile << g.edgeCount() << "  ,";  // Number of edges
     csvFile << randomizedResult << "  ,";  // Simple Randomized or Randomized-1
     csvFile << greedyResult << "  ,";  // Simple Greedy or Greedy-1
     csvFile << semiGreedyResult << "  ,";  // Semi Greedy - 1
     csvFile << iterations << "  ,";  // Simple local or local-1 No. of iterations
     csvFile << localSearchResult << "  ,";  // Average Value for Simple local
     csvFile << max_iterations << "  ,";  // GRASP No. of iterations
-    csvFile << graspResult << "\n";  // GRASP-1 Best value
-    csvFile << giveKnownbest(graphNum) << "\n";  // Known best value 
+    csvFile << graspResult << "  ,";  // GRASP-1 Best value
+    csvFile << knownBest << "  ,";  // Known best value
+    csvFile << spectral.positiveWeightBound << "  ,";  // positive weight, capped by Gershgorin
+    csvFile << spectral.estimate << "  ,";  // Lanczos estimate of the relaxation, not a bound
+    csvFile << spectralResult << "  ,";  // Spectral + local search
+    csvFile << seededGraspResult << "  ,";  // GRASP seeded with spectral + local search
+    csvFile << graspStats.iterations << "  ,";  // GRASP iterations actually run
+    csvFile << graspStats.duplicates << "  ,";  // iterations that reached a visited partition
+    csvFile << graspStats.skippedSearches << "  ,";  // of those, local searches skipped
+    csvFile << (double)graphBytes / g.edgeCount() << "  ,";  // graph bytes per edge
+    csvFile << (double)graspStats.peakBytes / g.V << "  ,";  // GRASP workspace bytes per vertex
+    csvFile << peakRSS / 1048576.0 << "\n";  // peak RSS in MB
 
 
     // Print the results to the console in a grid-like format (aligned)
@@ -118,11 +109,138 @@ void runAlgorithmsAndStoreResults(Graph& g, int graphNum, double alpha, ofstream
          << setw(25) << localSearchResult << endl;
     cout << setw(25) << left << "GRASP Max-Cut(iter,res)"
          << setw(25) <<max_iterations<<" ,"<< graspResult << endl;
+    cout << setw(25) << left << "Spectral + Local Search"
+         << setw(25) << spectralResult << endl;
+    cout << setw(25) << left << "GRASP Spectral Seeded"
+         << setw(25) << seededGraspResult << endl;
+    cout << setw(25) << left << "Positive Weight Bound"
+         << setw(25) << spectral.positiveWeightBound << endl;
+    cout << setw(25) << left << "Spectral Estimate"
+         << setw(25) << spectral.estimate << endl;
+    cout << setw(25) << left << "GRASP Duplicates(run,dup,skipped)"
+         << setw(25) << graspStats.iterations << " ," << graspStats.duplicates << " ," << graspStats.skippedSearches << endl;
+    if (exact.nodes > 0) {
+        cout << setw(25) << left << "Exact Max-Cut(cut,nodes,sec)"
+             << setw(25) << exact.cut << " ," << exact.nodes << " ," << exact.seconds << (exact.proven ? " proven" : " time limit") << endl;
+    }
+    cout << setw(25) << left << "Graph Memory" << footprint(graphBytes, g) << endl;
+    cout << setw(25) << left << "Graph Memory (packed)" << footprint(packedBytes, g) << endl;
+    cout << setw(25) << left << "GRASP Memory" << footprint(graspStats.peakBytes, g) << endl;
+    cout << setw(25) << left << "Spectral Memory" << footprint(spectral.peakBytes, g) << endl;
+    if (exact.nodes > 0) cout << setw(25) << left << "Exact Memory" << footprint(exact.peakBytes, g) << endl;
+    cout << setw(25) << left << "Peak RSS" << peakRSS / 1048576.0 << " MB" << endl;
     
 }
 
-int main()
+// "0.5,0.75" -> {0.5, 0.75}; for graph numbers also ranges, "1-10,22" -> {1, ..., 10, 22}
+vector<double> parseList(const string& text) {
+    vector<double> values;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t dash = item.find('-', 1);
+        if (dash == string::npos) {
+            values.push_back(stod(item));
+        } else {
+            for (int i = stoi(item.substr(0, dash)); i <= stoi(item.substr(dash + 1)); i++) values.push_back(i);
+        }
+    }
+    return values;
+}
+
+// One cell of a parameter sweep
+struct SweepCell {
+    int graphIndex;  // into the loaded graphs
+    double alpha;
+    int maxIterations;
+    unsigned seed;
+    long long cut = 0;
+    GRASPStats stats{};
+    double seconds = 0;
+};
+
+// GRASP over every graph x alpha x iterations x seed combination. Each graph is read and
+// preprocessed once and shared read-only by its cells; the cells run on a thread pool.
+// Usage: csv sweep <alphas> <iterations> <seeds> [graphs] [threads] [out.csv]
+// e.g.   csv sweep 0.5,0.6,0.7,0.8,0.9 10,50,100 1,2,3 1-54 8 sweep.csv
+int runSweep(int argc, char* argv[]) {
+    if (argc < 5) {
+        cerr << "Usage: " << argv[0] << " sweep <alphas> <iterations> <seeds> [graphs] [threads] [out.csv]" << endl;
+        return 1;
+    }
+    vector<double> alphas = parseList(argv[2]), iterations = parseList(argv[3]), seeds = parseList(argv[4]);
+    vector<double> graphNums = parseList(argc > 5 ? argv[5] : "1-54");
+    int threads = argc > 6 ? atoi(argv[6]) : max(1u, thread::hardware_concurrency());
+    string outPath = argc > 7 ? argv[7] : "2105107_sweep.csv";
+    auto start = chrono::steady_clock::now();
+
+    // Step 1: Load every graph once, in parallel
+    ThreadPool pool(threads);
+    vector<unique_ptr<const Graph>> graphs(graphNums.size());
+    for (size_t i = 0; i < graphNums.size(); i++) {
+        pool.submit([&, i]() {
+            string filename = "graph_GRASP/set1/g" + to_string((int)graphNums[i]) + ".rud";
+            try {
+                Graph g = readGraphFromFile(filename);
+                g.releaseEdges();
+                graphs[i] = make_unique<const Graph>(move(g));
+            } catch (const runtime_error& e) {
+                cerr << e.what() << ", skipped" << endl;
+            }
+        });
+    }
+    pool.wait();
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Step 2: One task per cell, largest graphs first so the tail is short
+    vector<SweepCell> cells;
+    for (size_t i = 0; i < graphs.size(); i++) {
+        if (!graphs[i]) continue;
+        for (double alpha : alphas)
+            for (double maxIterations : iterations)
+                for (double seed : seeds) cells.push_back({(int)i, alpha, (int)maxIterations, (unsigned)seed});
+    }
+    vector<int> schedule(cells.size());
+    for (size_t c = 0; c < cells.size(); c++) schedule[c] = c;
+    stable_sort(schedule.begin(), schedule.end(), [&](int a, int b) {
+        return graphs[cells[a].graphIndex]->edgeCount() > graphs[cells[b].graphIndex]->edgeCount();
+    });
+    for (int c : schedule) {
+        pool.submit([&, c]() {
+            SweepCell& cell = cells[c];
+            TraceScope trace("sweep cell", c);
+            auto cellStart = chrono::steady_clock::now();
+            MaxCutWorkspace ws(*graphs[cell.graphIndex]);
+            mt19937 rng(cell.seed);
+            cell.stats = GRASP(ws, cell.maxIterations, cell.alpha, rng);
+            cell.cut = ws.bestWeight;
+            cell.seconds = chrono::duration<double>(chrono::steady_clock::now() - cellStart).count();
+        });
+    }
+    pool.wait();
+
+    // Step 3: One tidy row per cell, in grid order
+    ofstream out(outPath);
+    out << "graph,vertices,edges,alpha,max_iterations,seed,cut,known_best,gap,iterations_run,duplicates,seconds\n";
+    for (const SweepCell& cell : cells) {
+        const Graph& g = *graphs[cell.graphIndex];
+        int graphNum = graphNums[cell.graphIndex];
+        int known = giveKnownbest(graphNum);
+        out << "G" << graphNum << "," << g.V << "," << g.edgeCount() << "," << cell.alpha << "," << cell.maxIterations << ","
+            << cell.seed << "," << cell.cut << "," << known << "," << (known >= 0 ? to_string(known - cell.cut) : "") << ","
+            << cell.stats.iterations << "," << cell.stats.duplicates << "," << cell.seconds << "\n";
+    }
+
+    double totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << cells.size() << " cells over " << graphs.size() << " graphs on " << pool.size() << " threads in " << totalSeconds
+         << " s (loading " << loadSeconds << " s), written to " << outPath << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[])
 {
+    TraceSession trace;  // MAXCUT_TRACE=<file.json> records a timeline of the run
+    if (argc > 1 && string(argv[1]) == "sweep") return runSweep(argc, argv);
     srand(time(0));
 
     // Open CSV file to write the results
@@ -131,20 +249,30 @@ int main()
 
     cout << "Generating CSV file for Max-Cut results..." << endl;
     // Writing CSV header
-    csvFile << "Problem,|V| or n,|E| or m,Simple Randomized or Randomized-1,Simple Greedy or Greedy-1,Semi Greedy - 1,Simple local or local-1 No. of iterations,Average Value, Grasp No. of iterations,Best Value, known best\n";
+    csvFile << "Problem,|V| or n,|E| or m,Simple Randomized or Randomized-1,Simple Greedy or Greedy-1,Semi Greedy - 1,Simple local or local-1 No. of iterations,Average Value, Grasp No. of iterations,Best Value, known best,Positive Weight Bound,Spectral Estimate,Spectral + Local,GRASP Spectral Seeded,GRASP Iterations Run,GRASP Duplicates,GRASP Skipped Searches,Graph Bytes/Edge,GRASP Bytes/Vertex,Peak RSS (MB)\n";
     auto program_start = chrono::high_resolution_clock::now();
     // Process graph files from g1.rud to g54.rud
     for (int i = 1; i <= 54; i++)
     {
+        TraceScope graphTrace("graph", i);
         auto start = chrono::high_resolution_clock::now();
         // Construct the filename for each graph file
         stringstream ss;
         ss << "graph_GRASP/set1/g" << i << ".rud";
         string filename = ss.str();
         cout << "Processing file: " << filename << endl;
+        resetPeakRSS();
 
-        // Read the graph from file
-        Graph g = readGraphFromFile(filename);
+        // Read the graph from file; everything runs on the CSR, so the edge list is dropped and the
+        // footprints below are what solving holds (the load itself still peaks with both)
+        Graph g(1);
+        try {
+            g = readGraphFromFile(filename);
+        } catch (const runtime_error& e) {
+            cerr << e.what() << ", skipped" << endl;
+            continue;
+        }
+        g.releaseEdges();
 
         // Run algorithms and store results in the CSV file
         runAlgorithmsAndStoreResults(g, i, 0.75, csvFile); // alpha = 0.75 for Semi-Greedy
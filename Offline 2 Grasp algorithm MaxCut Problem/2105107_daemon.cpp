@@ -0,0 +1,113 @@
+#include "2105107_maxcut.hpp"
+#include "2105107_daemon.hpp"
+#include "2105107_thread_pool.hpp"
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// One client; shared by its reader thread and its jobs, the socket closes with the last of them
+struct Connection {
+    int fd;
+    mutex writeMutex;
+
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { close(fd); }
+
+    void send(const string& line) {
+        lock_guard<mutex> lock(writeMutex);
+        string out = line + "\n";
+        size_t sent = 0;
+        while (sent < out.size()) {
+            ssize_t n = write(fd, out.data() + sent, out.size() - sent);
+            if (n <= 0) return;  // client went away, drop the rest
+            sent += n;
+        }
+    }
+};
+
+void sendError(Connection& conn, const string& id, const string& message) {
+    conn.send("{\"id\":\"" + jsonEscape(id) + "\",\"event\":\"error\",\"message\":\"" + jsonEscape(message) + "\"}");
+}
+
+// Read newline-separated JSON jobs and queue each on the pool
+void serveClient(shared_ptr<Connection> conn, ThreadPool& pool, GraphCache& cache) {
+    string buffer;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = read(conn->fd, chunk, sizeof(chunk))) > 0) {
+        buffer.append(chunk, n);
+        size_t newline;
+        while ((newline = buffer.find('\n')) != string::npos) {
+            string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line.empty()) continue;
+
+            // A job that throws (e.g. bad_alloc on a huge graph) only fails itself, never the daemon
+            SolveJob job;
+            string error;
+            try {
+                error = parseJob(line, job);
+            } catch (const exception& e) {
+                error = string("cannot build job: ") + e.what();
+            }
+            if (!error.empty()) {
+                sendError(*conn, job.id, error);
+                continue;
+            }
+            pool.submit([conn, job, &cache]() {
+                try {
+                    shared_ptr<const Graph> graph = job.graph;
+                    bool cached = false;
+                    if (!graph) {
+                        try {
+                            graph = cache.get(job.graphPath, cached);
+                        } catch (const runtime_error& e) {
+                            sendError(*conn, job.id, e.what());
+                            return;
+                        }
+                    }
+                    conn->send("{\"id\":\"" + jsonEscape(job.id) + "\",\"event\":\"started\",\"cached\":" + (cached ? "true" : "false") + "}");
+                    runJob(*graph, job, [&](const string& result) { conn->send(result); });
+                } catch (const exception& e) {
+                    sendError(*conn, job.id, string("job failed: ") + e.what());
+                }
+            });
+        }
+    }
+}
+
+// Max-Cut solver daemon
+// Usage: daemon [socket-path] [threads] [cached-graphs]
+// Each line sent to the socket is one JSON job; results come back as JSON lines on the same connection.
+int main(int argc, char* argv[]) {
+    string socketPath = argc > 1 ? argv[1] : "/tmp/maxcut.sock";
+    int threads = argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    int cachedGraphs = argc > 3 ? atoi(argv[3]) : 16;
+    signal(SIGPIPE, SIG_IGN);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (server < 0 || socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Cannot create socket " << socketPath << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (bind(server, (sockaddr*)&address, sizeof(address)) != 0 || listen(server, 64) != 0) {
+        cerr << "Cannot listen on " << socketPath << endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    GraphCache cache(cachedGraphs);
+    cout << "Max-Cut daemon listening on " << socketPath << " with " << pool.size() << " threads" << endl;
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) continue;
+        auto conn = make_shared<Connection>(client);
+        thread(serveClient, conn, ref(pool), ref(cache)).detach();
+    }
+}
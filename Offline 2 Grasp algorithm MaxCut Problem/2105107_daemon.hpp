@@ -0,0 +1,309 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include "2105107_spectral.hpp"
+#include "2105107_lns.hpp"
+#include "2105107_vns.hpp"
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+// Minimal JSON value, enough for one-line job requests
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array, Object } type = Null;
+    double number = 0;
+    string text;
+    vector<JsonValue> items;
+    vector<pair<string, JsonValue>> fields;
+
+    const JsonValue* get(const string& key) const {
+        for (const auto& [name, value] : fields)
+            if (name == key) return &value;
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const string& input) : s(input) {}
+
+    // Parse one value covering the whole input; false on malformed text
+    bool parse(JsonValue& out) {
+        if (!value(out)) return false;
+        skipSpace();
+        return pos == s.size();
+    }
+
+private:
+    const string& s;
+    size_t pos = 0;
+
+    void skipSpace() {
+        while (pos < s.size() && isspace((unsigned char)s[pos])) pos++;
+    }
+
+    bool literal(const char* word) {
+        size_t len = strlen(word);
+        if (s.compare(pos, len, word) != 0) return false;
+        pos += len;
+        return true;
+    }
+
+    bool stringValue(string& out) {
+        if (s[pos] != '"') return false;
+        pos++;
+        while (pos < s.size() && s[pos] != '"') {
+            if (s[pos] == '\\' && pos + 1 < s.size()) {
+                pos++;
+                char c = s[pos];
+                out += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+            } else {
+                out += s[pos];
+            }
+            pos++;
+        }
+        if (pos >= s.size()) return false;
+        pos++;
+        return true;
+    }
+
+    bool value(JsonValue& out) {
+        skipSpace();
+        if (pos >= s.size()) return false;
+        char c = s[pos];
+        if (c == '"') {
+            out.type = JsonValue::String;
+            return stringValue(out.text);
+        }
+        if (c == '[') {
+            out.type = JsonValue::Array;
+            pos++;
+            skipSpace();
+            if (pos < s.size() && s[pos] == ']') { pos++; return true; }
+            while (true) {
+                out.items.emplace_back();
+                if (!value(out.items.back())) return false;
+                skipSpace();
+                if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+                if (pos < s.size() && s[pos] == ']') { pos++; return true; }
+                return false;
+            }
+        }
+        if (c == '{') {
+            out.type = JsonValue::Object;
+            pos++;
+            skipSpace();
+            if (pos < s.size() && s[pos] == '}') { pos++; return true; }
+            while (true) {
+                skipSpace();
+                string key;
+                if (pos >= s.size() || !stringValue(key)) return false;
+                skipSpace();
+                if (pos >= s.size() || s[pos] != ':') return false;
+                pos++;
+                out.fields.emplace_back(key, JsonValue());
+                if (!value(out.fields.back().second)) return false;
+                skipSpace();
+                if (pos < s.size() && s[pos] == ',') { pos++; continue; }
+                if (pos < s.size() && s[pos] == '}') { pos++; return true; }
+                return false;
+            }
+        }
+        if (literal("true")) { out.type = JsonValue::Bool; out.number = 1; return true; }
+        if (literal("false")) { out.type = JsonValue::Bool; return true; }
+        if (literal("null")) return true;
+        const char* start = s.c_str() + pos;
+        char* end;
+        out.number = strtod(start, &end);
+        if (end == start) return false;
+        out.type = JsonValue::Number;
+        pos += end - start;
+        return true;
+    }
+};
+
+string jsonEscape(const string& text) {
+    string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+    }
+    return out;
+}
+
+// Recently used graphs in CSR form, keyed by path, least recently used evicted first
+class GraphCache {
+public:
+    explicit GraphCache(size_t capacity) : capacity(max<size_t>(1, capacity)) {}
+
+    // hit tells whether it was already cached. Throws runtime_error, as readGraphFromFile does,
+    // if the file cannot be read or is not a valid graph; nothing is cached then.
+    shared_ptr<const Graph> get(const string& path, bool& hit) {
+        {
+            lock_guard<mutex> lock(cacheMutex);
+            auto it = index.find(path);
+            if (it != index.end()) {
+                order.splice(order.begin(), order, it->second);
+                hit = true;
+                return it->second->second;
+            }
+        }
+        hit = false;
+        // Parse outside the lock so other jobs keep using the cache meanwhile
+        Graph loaded = readGraphFromFile(path);
+        loaded.releaseEdges();  // cached graphs are only solved, from the CSR
+        auto graph = make_shared<const Graph>(move(loaded));
+
+        lock_guard<mutex> lock(cacheMutex);
+        if (index.count(path)) return index[path]->second;
+        order.emplace_front(path, graph);
+        index[path] = order.begin();
+        if (order.size() > capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        return graph;
+    }
+
+private:
+    size_t capacity;
+    mutex cacheMutex;
+    list<pair<string, shared_ptr<const Graph>>> order;
+    unordered_map<string, list<pair<string, shared_ptr<const Graph>>>::iterator> index;
+};
+
+struct SolveJob {
+    string id;
+    string graphPath;               // either a .rud path ...
+    shared_ptr<const Graph> graph;  // ... or edges given inline
+    string algorithm = "grasp";     // grasp, vns (GRASP with VNS), lns, semigreedy, local or spectral
+    double alpha = 0.75;
+    double seconds = 1;             // time budget for grasp, vns and lns
+    int iterations = 50;            // iteration cap for grasp and vns, which also stop after 10 without a new best
+    unsigned seed = 0;              // 0 picks a random seed
+};
+
+// Largest graph accepted inline; bigger ones should come as a .rud path
+const int MAX_INLINE_VERTICES = 1 << 20;
+// GRASP sizes its visited set for the iteration cap, 16 bytes per iteration
+const int MAX_JOB_ITERATIONS = 100000;
+
+// Read an integral number in [lo, hi] from v into out; false if v is not one
+bool integralField(const JsonValue& v, double lo, double hi, long long& out) {
+    if (v.type != JsonValue::Number || !(v.number >= lo && v.number <= hi) || v.number != floor(v.number)) return false;
+    out = (long long)v.number;
+    return true;
+}
+
+// Fill job from a request like
+// {"id":"a","graph":"g1.rud","algorithm":"grasp","alpha":0.75,"seconds":2,"seed":7}
+// or with "vertices":4,"edges":[[1,2,1],[2,3,-1]] instead of "graph". Returns an error message or "".
+string parseJob(const string& line, SolveJob& job) {
+    JsonValue request;
+    if (!JsonParser(line).parse(request) || request.type != JsonValue::Object) return "malformed JSON";
+
+    long long number;
+    if (auto v = request.get("id")) job.id = v->type == JsonValue::String ? v->text : to_string((long long)v->number);
+    if (auto v = request.get("algorithm")) job.algorithm = v->text;
+    if (auto v = request.get("alpha")) {
+        if (v->type != JsonValue::Number || !(v->number >= 0 && v->number <= 1)) return "alpha must be in [0, 1]";
+        job.alpha = v->number;
+    }
+    if (auto v = request.get("seconds")) {
+        if (v->type != JsonValue::Number || !(v->number >= 0 && v->number <= 1e6)) return "seconds out of range";
+        job.seconds = v->number;
+    }
+    if (auto v = request.get("iterations")) {
+        if (!integralField(*v, 1, MAX_JOB_ITERATIONS, number))
+            return "iterations must be an integer from 1 to " + to_string(MAX_JOB_ITERATIONS);
+        job.iterations = number;
+    }
+    if (auto v = request.get("seed")) {
+        if (!integralField(*v, 0, UINT_MAX, number)) return "seed must be an integer from 0 to " + to_string(UINT_MAX);
+        job.seed = number;
+    }
+    if (job.algorithm != "grasp" && job.algorithm != "vns" && job.algorithm != "lns" && job.algorithm != "semigreedy" && job.algorithm != "local" && job.algorithm != "spectral")
+        return "unknown algorithm " + job.algorithm;
+
+    if (auto v = request.get("graph")) {
+        job.graphPath = v->text;
+        return "";
+    }
+    const JsonValue* vertices = request.get("vertices");
+    const JsonValue* edges = request.get("edges");
+    if (!vertices || !edges || edges->type != JsonValue::Array) return "need \"graph\" or \"vertices\" and \"edges\"";
+    if (!integralField(*vertices, 1, MAX_INLINE_VERTICES, number))
+        return "vertices must be an integer from 1 to " + to_string(MAX_INLINE_VERTICES);
+    auto graph = make_shared<Graph>((int)number);
+    for (const JsonValue& e : edges->items) {
+        if (e.items.size() != 3) return "each edge must be [u, v, weight]";
+        long long u, v, weight;
+        if (!integralField(e.items[0], 1, graph->V, u) || !integralField(e.items[1], 1, graph->V, v))
+            return "edge endpoint out of range";
+        if (!integralField(e.items[2], INT_MIN, INT_MAX, weight)) return "edge weight must be a 32-bit integer";
+        graph->addEdge(u, v, weight);
+    }
+    graph->buildCSR();
+    graph->releaseEdges();
+    job.graph = graph;
+    return "";
+}
+
+// Run one job, passing each JSON result line to emit: "improved" events while GRASP
+// runs, then one "done" line with the cut weight and the sides as a 0/1 string
+void runJob(const Graph& g, const SolveJob& job, const function<void(const string&)>& emit) {
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&]() { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+    mt19937 rng(job.seed ? job.seed : random_device{}());
+    MaxCutWorkspace ws(g);
+    int iterations = 0;
+
+    if (job.algorithm == "spectral") {
+        SpectralResult spectral = spectralMaxCut(g, rng);
+        setsToSide(spectral.X, spectral.Y, ws.side);
+        computeGains(ws);
+        localSearch(ws);
+        ws.keepAsBest();
+    } else if (job.algorithm == "semigreedy" || job.algorithm == "local") {
+        semiGreedyConstruct(ws, job.alpha, rng);
+        if (job.algorithm == "local") iterations = localSearch(ws);
+        ws.keepAsBest();
+    } else if (job.algorithm == "lns") {
+        LNSConfig config;
+        config.seconds = job.seconds;
+        config.alpha = job.alpha;
+        iterations = largeNeighbourhoodSearch(ws, config, rng).steps;
+    } else {
+        // The library GRASP with its defaults, as GRASP(ws, ...) and vnsGRASP run it, plus the time budget
+        auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(job.seconds));
+        auto improved = [&](const MaxCutWorkspace& w, int iteration) {
+            ostringstream line;
+            line << "{\"id\":\"" << jsonEscape(job.id) << "\",\"event\":\"improved\",\"iteration\":" << iteration
+                 << ",\"cut\":" << w.bestWeight << ",\"seconds\":" << elapsed() << "}";
+            emit(line.str());
+        };
+        GRASPStats stats;
+        if (job.algorithm == "vns") {
+            VariableNeighbourhoodSearch vns(g);
+            stats = GRASP(ws, job.iterations, job.alpha, rng, [&](MaxCutWorkspace& w) { vns.improve(w, rng); }, false, 10, false, 0.8, 10,
+                          deadline, improved);
+        } else {
+            stats = GRASP(ws, job.iterations, job.alpha, rng, [](MaxCutWorkspace& w) { localSearch(w); }, true, 10, false, 0.8, 10,
+                          deadline, improved);
+        }
+        iterations = stats.iterations;
+    }
+
+    ostringstream line;
+    line << "{\"id\":\"" << jsonEscape(job.id) << "\",\"event\":\"done\",\"algorithm\":\"" << job.algorithm
+         << "\",\"cut\":" << ws.bestWeight << ",\"iterations\":" << iterations << ",\"seconds\":" << elapsed()
+         << ",\"sides\":\"";
+    for (int v = 1; v <= g.V; v++) line << (int)ws.bestSide[v];
+    line << "\"}";
+    emit(line.str());
+}
@@ -0,0 +1,85 @@
+#include "2105107_maxcut.hpp"
+#include <iomanip>
+
+// Random graph with each edge present with probability density, weights 1 or +-1
+Graph randomGraph(int V, double density, bool signedWeights, mt19937& rng) {
+    Graph g(V);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int u = 1; u <= V; u++)
+        for (int v = u + 1; v <= V; v++)
+            if (unit(rng) < density) g.addEdge(u, v, signedWeights && rng() % 2 ? -1 : 1);
+    g.buildCSR();
+    return g;
+}
+
+struct KernelTimes {
+    double gains = 0, search = 0;  // microseconds per call
+    long long checksum = 0;
+};
+
+// Time computeGains on one random partition and local search from `starts` random partitions,
+// with the CSR kernels or (bits) the bitset ones
+KernelTimes timeKernels(const Graph& g, bool bits, int starts) {
+    KernelTimes t;
+    MaxCutWorkspace ws(g);
+    mt19937 rng(7);
+    for (int v = 1; v <= g.V; v++) ws.side[v] = rng() % 2;
+    int repeats = 200;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        if (bits) computeDenseGains(ws);
+        else withKernelTypes(g, [&](auto weights, auto acc) { computeGains<decltype(acc)>(ws, weights); });
+        t.checksum += ws.cutWeight;
+    }
+    t.gains = chrono::duration<double>(chrono::steady_clock::now() - start).count() / repeats * 1e6;
+
+    double seconds = 0;
+    for (int i = 0; i < starts; i++) {
+        for (int v = 1; v <= g.V; v++) ws.side[v] = rng() % 2;
+        computeGains(ws);
+        start = chrono::steady_clock::now();
+        if (bits) denseLocalSearch(ws);
+        else withWeights(g, [&](auto weights) { localSearch(ws, weights); });
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        t.checksum += ws.cutWeight;
+    }
+    t.search = seconds / starts * 1e6;
+    return t;
+}
+
+void compare(const string& name, const Graph& g) {
+    Graph dense = g;
+    if (!dense.buildDense()) {
+        cout << name << ": no bitset layout (self-loops, parallel edges or too many weights)" << endl;
+        return;
+    }
+    KernelTimes a = timeKernels(dense, false, 50), b = timeKernels(dense, true, 50);
+    string chosen = !g.isDense() ? "CSR" : g.density() >= Graph::denseSearchThreshold ? "bits" : "bits+CSR LS";
+    cout << left << setw(14) << name << right << setw(7) << g.V << setw(9) << g.edgeCount() << setw(9) << g.density() * 100 << "%"
+         << setw(11) << a.gains << setw(11) << b.gains << setw(11) << a.search << setw(11) << b.search
+         << "  " << chosen << (a.checksum != b.checksum ? "  RESULTS DIFFER" : "") << endl;
+}
+
+// CSR vs bitset adjacency: computeGains and local search times (microseconds) per graph.
+// Usage: dense_bench [graph.rud ...]; without arguments sweeps the density of random 800-vertex graphs
+int main(int argc, char* argv[]) {
+    cout << fixed << setprecision(2);
+    cout << left << setw(14) << "graph" << right << setw(7) << "V" << setw(9) << "E" << setw(10) << "density"
+         << setw(11) << "gains CSR" << setw(11) << "gains bits" << setw(11) << "LS CSR" << setw(11) << "LS bits" << "  auto" << endl;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            try {
+                compare(argv[i], readGraphFromFile(argv[i]));
+            } catch (const runtime_error& e) {
+                cerr << e.what() << endl;
+                return 2;
+            }
+        }
+        return 0;
+    }
+    mt19937 rng(42);
+    for (double density : {0.0025, 0.005, 0.01, 0.02, 0.04, 0.06, 0.1, 0.2, 0.4}) {
+        compare("random " + to_string(density).substr(0, 6), randomGraph(800, density, true, rng));
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <unordered_map>
+
+struct EdgeUpdate {
+    enum Kind { Insert, Delete, Reweight } kind;
+    int u, v;
+    int weight;  // added weight for Insert, new weight for Reweight, unused for Delete
+};
+
+// Max-Cut that stays solved while its graph changes.
+// Keeps the partition, the gain table and the cut weight; an update batch adjusts them in
+// O(1) per changed edge and then repairs the partition by local search that only starts
+// from the touched vertices, spreading to a neighbour only when its gain turns positive.
+class DynamicMaxCut {
+public:
+    int V;
+    vector<unordered_map<int, int>> adj;  // adj[u][v] = total weight of the u-v edges
+    vector<signed char> side;
+    vector<long long> gain;
+    long long cutWeight = 0;
+
+    // Start from g and a complete partition of it (for example a GRASP result)
+    DynamicMaxCut(const Graph& g, const vector<signed char>& initialSide)
+        : V(g.V), adj(g.V + 1), side(initialSide), gain(g.V + 1, 0), queued(g.V + 1, false) {
+        forEachEdge(g, [&](int u, int v, int weight) {
+            adj[u][v] += weight;
+            adj[v][u] += weight;
+        });
+        for (int u = 1; u <= V; u++) {
+            for (const auto& [v, w] : adj[u]) {
+                if (side[u] == side[v]) gain[u] += w;
+                else {
+                    gain[u] -= w;
+                    if (u < v) cutWeight += w;
+                }
+            }
+        }
+    }
+
+    // Apply a batch of edge changes, then locally repair; returns the number of vertices flipped
+    int applyBatch(const vector<EdgeUpdate>& batch) {
+        for (const EdgeUpdate& update : batch) {
+            if (update.u == update.v || update.u < 1 || update.v < 1 || update.u > V || update.v > V) continue;
+            auto it = adj[update.u].find(update.v);
+            int old = it == adj[update.u].end() ? 0 : it->second;
+            int now = update.kind == EdgeUpdate::Insert ? old + update.weight
+                    : update.kind == EdgeUpdate::Reweight ? update.weight : 0;
+            if (now == old) continue;
+            if (now == 0) {
+                adj[update.u].erase(update.v);
+                adj[update.v].erase(update.u);
+            } else {
+                adj[update.u][update.v] = now;
+                adj[update.v][update.u] = now;
+            }
+            changeWeight(update.u, update.v, now - old);
+        }
+        return repair();
+    }
+
+    // Current edges as a static graph, e.g. to re-run GRASP from scratch
+    Graph toGraph() const {
+        Graph g(V);
+        for (int u = 1; u <= V; u++)
+            for (const auto& [v, w] : adj[u])
+                if (u < v) g.addEdge(u, v, w);
+        g.buildCSR();
+        return g;
+    }
+
+private:
+    vector<bool> queued;
+    vector<int> worklist;
+
+    void changeWeight(int u, int v, long long delta) {
+        if (side[u] == side[v]) {
+            gain[u] += delta;
+            gain[v] += delta;
+        } else {
+            gain[u] -= delta;
+            gain[v] -= delta;
+            cutWeight += delta;
+        }
+        push(u);
+        push(v);
+    }
+
+    void push(int v) {
+        if (!queued[v] && gain[v] > 0) {
+            queued[v] = true;
+            worklist.push_back(v);
+        }
+    }
+
+    int repair() {
+        int flips = 0;
+        while (!worklist.empty()) {
+            int v = worklist.back();
+            worklist.pop_back();
+            queued[v] = false;
+            if (gain[v] <= 0) continue;
+            cutWeight += gain[v];
+            for (const auto& [u, w] : adj[v]) {
+                gain[u] += side[u] == side[v] ? -2LL * w : 2LL * w;
+                push(u);
+            }
+            side[v] ^= 1;
+            gain[v] = -gain[v];
+            flips++;
+        }
+        return flips;
+    }
+};
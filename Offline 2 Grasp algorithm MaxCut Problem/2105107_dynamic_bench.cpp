@@ -0,0 +1,108 @@
+#include "2105107_maxcut.hpp"
+#include "2105107_dynamic.hpp"
+#include <iomanip>
+
+// Random batch: a third inserts, a third deletes, a third reweights existing edges
+vector<EdgeUpdate> randomBatch(const DynamicMaxCut& dyn, int size, mt19937& rng) {
+    vector<EdgeUpdate> batch;
+    while ((int)batch.size() < size) {
+        int kind = rng() % 3;
+        int u = rng() % dyn.V + 1;
+        int weight = rng() % 2 ? 1 : -1;
+        if (kind == 0) {
+            int v = rng() % dyn.V + 1;
+            batch.push_back({EdgeUpdate::Insert, u, v, weight});
+            continue;
+        }
+        if (dyn.adj[u].empty()) continue;
+        auto it = dyn.adj[u].begin();
+        advance(it, rng() % dyn.adj[u].size());
+        if (kind == 1) batch.push_back({EdgeUpdate::Delete, u, it->first, 0});
+        else batch.push_back({EdgeUpdate::Reweight, u, it->first, weight});
+    }
+    return batch;
+}
+
+// Latency of incremental re-optimisation per update batch against a full GRASP re-run
+// Usage: dynamic_bench <graph.rud> [batches] [batch-size] [grasp-every]
+// grasp-every 0 skips the full GRASP comparison. Exits 1 if the maintained cut ever
+// disagrees with a recount, checked at each GRASP comparison and after the last batch.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <graph.rud> [batches] [batch-size] [grasp-every]" << endl;
+        return 1;
+    }
+    int batches = argc > 2 ? atoi(argv[2]) : 1000;
+    int batchSize = argc > 3 ? atoi(argv[3]) : 10;
+    int graspEvery = argc > 4 ? atoi(argv[4]) : 100;
+    if (batches < 1 || batchSize < 1 || graspEvery < 0) {
+        cerr << "batches and batch-size must be at least 1, grasp-every at least 0" << endl;
+        return 2;
+    }
+    int graspIterations = 50;
+    double alpha = 0.75;
+
+    Graph g(1);
+    try {
+        g = readGraphFromFile(argv[1]);
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    MaxCutWorkspace ws(g);
+    mt19937 rng(42);
+    GRASP(ws, graspIterations, alpha, rng);
+    DynamicMaxCut dyn(g, ws.bestSide);
+    cout << "Initial GRASP cut: " << dyn.cutWeight << endl;
+
+    double incrementalSeconds = 0, worstBatch = 0, graspSeconds = 0;
+    long long flips = 0;
+    int graspRuns = 0;
+    long long cutGapSum = 0;
+    int mismatches = 0;
+    // The maintained cut must match a recount on the current graph
+    auto checkCut = [&](const Graph& current, int b) {
+        MaxCutWorkspace check(current);
+        check.side = dyn.side;
+        computeGains(check);
+        if (check.cutWeight == dyn.cutWeight) return;
+        cout << "Cut mismatch after batch " << b << ": " << dyn.cutWeight << " vs " << check.cutWeight << endl;
+        mismatches++;
+    };
+    for (int b = 1; b <= batches; b++) {
+        vector<EdgeUpdate> batch = randomBatch(dyn, batchSize, rng);
+        auto start = chrono::steady_clock::now();
+        flips += dyn.applyBatch(batch);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        incrementalSeconds += seconds;
+        worstBatch = max(worstBatch, seconds);
+
+        if (graspEvery > 0 && b % graspEvery == 0) {
+            // Full re-solve of the same graph, including building it
+            start = chrono::steady_clock::now();
+            Graph current = dyn.toGraph();
+            MaxCutWorkspace fresh(current);
+            GRASP(fresh, graspIterations, alpha, rng);
+            graspSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            graspRuns++;
+            cutGapSum += fresh.bestWeight - dyn.cutWeight;
+            checkCut(current, b);
+        }
+    }
+    if (graspEvery == 0 || batches % graspEvery != 0) checkCut(dyn.toGraph(), batches);
+
+    cout << fixed << setprecision(3);
+    cout << "Batches: " << batches << " of " << batchSize << " updates, " << flips << " repair flips" << endl;
+    cout << "Incremental: mean " << incrementalSeconds / batches * 1e6 << " us, worst " << worstBatch * 1e6 << " us per batch" << endl;
+    if (graspRuns > 0) {
+        cout << "Full GRASP:  mean " << graspSeconds / graspRuns * 1e6 << " us per re-run (" << graspRuns << " runs)" << endl;
+        cout << "Speedup: " << (graspSeconds / graspRuns) / (incrementalSeconds / batches) << "x" << endl;
+        cout << "Mean cut gap, GRASP minus incremental: " << (double)cutGapSum / graspRuns << endl;
+    }
+    cout << "Final incremental cut: " << dyn.cutWeight << endl;
+    if (mismatches > 0) {
+        cout << mismatches << " cut mismatch(es)" << endl;
+        return 1;
+    }
+    return 0;
+}
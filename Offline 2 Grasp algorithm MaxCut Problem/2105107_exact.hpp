@@ -0,0 +1,231 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+// Exact Max-Cut by branch and bound, for small graphs.
+//
+// Vertices are put in a fixed order and the suffixes of that order are solved from the shortest
+// up (Russian doll search): the optimum of positions k+1.. bounds the edges among the unassigned
+// vertices while solving positions k.., and extended by vertex k it is also the first incumbent.
+// A node with positions k..d-1 assigned is pruned when
+//     cut so far + sum over unassigned u of max(weight to X, weight to Y) + optimum of d..
+// cannot beat the incumbent. Both sums are kept incrementally as vertices are assigned.
+
+// Largest graph exactMaxCut accepts; a partition is two 64-bit words
+const int maxExactVertices = 128;
+
+struct ExactResult {
+    long long cut = 0;
+    vector<signed char> side;  // 1-based, 0 for X and 1 for Y
+    long long nodes = 0;       // search nodes over all suffix problems
+    double seconds = 0;
+    bool proven = false;       // false if the time limit ran out; cut is then the best found
+    size_t peakBytes = 0;      // weight matrix, bitsets and one search state per thread
+};
+
+class ExactMaxCut {
+public:
+    ExactMaxCut(const Graph& g, double timeLimit) : n(g.V), order(g.V), w(g.V * g.V, 0), adj(g.V) {
+        deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeLimit));
+
+        // Step 1: Strong ordering. Start from the heaviest vertex, then always take the one most
+        // strongly joined to those already placed, so assignments constrain the next ones early.
+        vector<long long> degree(n + 1, 0), link(n + 1, 0);
+        vector<vector<pair<int, int>>> neighbours(n + 1);
+        forEachEdge(g, [&](int u, int v, int weight) {
+            if (u == v) return;  // a self-loop is never cut
+            degree[u] += abs(weight);
+            degree[v] += abs(weight);
+            neighbours[u].push_back({v, weight});
+            neighbours[v].push_back({u, weight});
+        });
+        vector<int> position(n + 1, -1);
+        for (int p = 0; p < n; p++) {
+            int next = -1;
+            for (int v = 1; v <= n; v++) {
+                if (position[v] == -1 && (next == -1 || link[v] > link[next] || (link[v] == link[next] && degree[v] > degree[next])))
+                    next = v;
+            }
+            position[next] = p;
+            order[p] = next;
+            for (auto [u, weight] : neighbours[next]) link[u] += abs(weight);
+        }
+
+        // Step 2: Weight matrix and adjacency bitsets by position
+        forEachEdge(g, [&](int u, int v, int weight) {
+            if (u == v) return;
+            int a = position[u], b = position[v];
+            w[a * n + b] += weight;
+            w[b * n + a] += weight;
+        });
+        for (int a = 0; a < n; a++)
+            for (int b = 0; b < n; b++)
+                if (w[a * n + b] != 0) adj[a][b / 64] |= 1ULL << (b % 64);
+    }
+
+    // seed, if given, is a complete partition (say from GRASP) whose restriction to each suffix
+    // competes with the extended optimum as its first incumbent
+    ExactResult solve(const vector<signed char>* seed = nullptr) {
+        auto start = chrono::steady_clock::now();
+        ExactResult result;
+        vector<long long> best(n + 1, 0);
+        Bits bestY = {0, 0};  // optimum of the current suffix, as positions in Y
+
+        for (int first = n - 1; first >= 0; first--) {
+            // Step 1: Extend the previous optimum by `first`, on whichever side cuts more
+            long long toX = 0, toY = 0;
+            for (int u = first + 1; u < n; u++) (has(bestY, u) ? toY : toX) += w[first * n + u];
+            if (toX > toY) {
+                // first goes to Y; swap sides so it stays in X
+                for (int u = first + 1; u < n; u++) bestY[u / 64] ^= 1ULL << (u % 64);
+            }
+            incumbent = best[first + 1] + max(toX, toY);
+            incumbentY = bestY;
+            if (seed) offerSeed(first, *seed);
+
+            // Step 2: Search for a better cut with `first` fixed in X, unless time is up
+            if (!stopped) searchSuffix(first, best);
+            best[first] = incumbent;
+            bestY = incumbentY;
+        }
+
+        result.cut = best[0];
+        result.side.assign(n + 1, 0);
+        for (int p = 0; p < n; p++) result.side[order[p]] = has(bestY, p);
+        result.nodes = nodes;
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.proven = !stopped;
+        result.peakBytes = vectorBytes(order) + vectorBytes(w) + vectorBytes(adj) + omp_get_max_threads() * sizeof(State);
+        return result;
+    }
+
+private:
+    using Bits = array<uint64_t, 2>;
+
+    // Partial assignment of positions first..depth-1
+    struct State {
+        long long toX[maxExactVertices], toY[maxExactVertices];  // weight from unassigned u to X / Y
+        Bits y;                                                  // assigned positions in Y
+        long long cut, slack;                                    // slack = sum of max(toX[u], toY[u])
+        long long nodes;
+    };
+
+    int n;
+    vector<int> order;  // position -> vertex
+    vector<int> w;      // w[a * n + b]: total weight between positions a and b
+    vector<Bits> adj;   // positions joined by a non-zero weight
+    chrono::steady_clock::time_point deadline;
+
+    atomic<long long> incumbent{0}, nodes{0};
+    atomic<bool> stopped{false};
+    Bits incumbentY;
+    mutex incumbentMutex;
+
+    static bool has(const Bits& bits, int p) { return bits[p / 64] >> (p % 64) & 1; }
+
+    // Put position p on side s (1 for Y); neighbours after p are the unassigned ones
+    void assign(State& st, int p, int s) const {
+        st.slack -= max(st.toX[p], st.toY[p]);
+        st.cut += s ? st.toX[p] : st.toY[p];
+        if (s) st.y[p / 64] |= 1ULL << (p % 64);
+        for (int k = p / 64; k < 2; k++) {
+            uint64_t later = adj[p][k] & (k == p / 64 ? ~0ULL << (p % 64) << 1 : ~0ULL);
+            for (; later; later &= later - 1) {
+                int u = k * 64 + __builtin_ctzll(later);
+                long long old = max(st.toX[u], st.toY[u]);
+                (s ? st.toY[u] : st.toX[u]) += w[p * n + u];
+                st.slack += max(st.toX[u], st.toY[u]) - old;
+            }
+        }
+    }
+
+    void unassign(State& st, int p, int s) const {
+        for (int k = p / 64; k < 2; k++) {
+            uint64_t later = adj[p][k] & (k == p / 64 ? ~0ULL << (p % 64) << 1 : ~0ULL);
+            for (; later; later &= later - 1) {
+                int u = k * 64 + __builtin_ctzll(later);
+                long long old = max(st.toX[u], st.toY[u]);
+                (s ? st.toY[u] : st.toX[u]) -= w[p * n + u];
+                st.slack += max(st.toX[u], st.toY[u]) - old;
+            }
+        }
+        if (s) st.y[p / 64] &= ~(1ULL << (p % 64));
+        st.cut -= s ? st.toX[p] : st.toY[p];
+        st.slack += max(st.toX[p], st.toY[p]);
+    }
+
+    void offer(const State& st) {
+        lock_guard<mutex> lock(incumbentMutex);
+        if (st.cut > incumbent) {
+            incumbent = st.cut;
+            incumbentY = st.y;
+        }
+    }
+
+    void offerSeed(int first, const vector<signed char>& seed) {
+        // Sides by position, with first in X
+        Bits y = {0, 0};
+        for (int p = first; p < n; p++)
+            if (seed[order[p]] != seed[order[first]]) y[p / 64] |= 1ULL << (p % 64);
+        long long cut = 0;
+        for (int a = first; a < n; a++)
+            for (int b = a + 1; b < n; b++)
+                if (has(y, a) != has(y, b)) cut += w[a * n + b];
+        if (cut > incumbent) {
+            incumbent = cut;
+            incumbentY = y;
+        }
+    }
+
+    void search(State& st, int depth, const vector<long long>& best) {
+        if (depth == n) {
+            if (st.cut > incumbent) offer(st);
+            return;
+        }
+        if ((++st.nodes & 4095) == 0 && chrono::steady_clock::now() > deadline) stopped = true;
+        if (stopped || st.cut + st.slack + best[depth] <= incumbent) return;
+        // Try first the side that cuts more of what is already assigned
+        int s = st.toX[depth] >= st.toY[depth] ? 1 : 0;
+        for (int branch = 0; branch < 2; branch++, s ^= 1) {
+            assign(st, depth, s);
+            search(st, depth + 1, best);
+            unassign(st, depth, s);
+        }
+    }
+
+    // Solve positions first.. with first fixed in X. Longer suffixes are split into 2^split
+    // subtrees by the sides of the next positions and searched in parallel.
+    void searchSuffix(int first, const vector<long long>& best) {
+        int remaining = n - first - 1;
+        int split = remaining > 24 ? min(remaining - 16, 10) : 0;
+        #pragma omp parallel for schedule(dynamic) if (split > 0)
+        for (int task = 0; task < (1 << split); task++) {
+            State st;
+            fill(st.toX, st.toX + n, 0);
+            fill(st.toY, st.toY + n, 0);
+            st.y = {0, 0};
+            st.cut = st.slack = st.nodes = 0;
+            assign(st, first, 0);
+            bool alive = true;
+            for (int i = 0; i < split && alive; i++) {
+                assign(st, first + 1 + i, task >> i & 1);
+                alive = st.cut + st.slack + best[first + 2 + i] > incumbent;
+            }
+            if (alive) search(st, first + 1 + split, best);
+            nodes += st.nodes + 1;
+        }
+    }
+};
+
+// Proven maximum cut of g (at most maxExactVertices vertices) unless timeLimit seconds run out
+// first. A heuristic partition as seed (1-based sides) can only speed the search up.
+ExactResult exactMaxCut(const Graph& g, double timeLimit = 60, const vector<signed char>* seed = nullptr) {
+    if (g.V > maxExactVertices) {
+        cerr << "exactMaxCut: " << g.V << " vertices, at most " << maxExactVertices << " supported" << endl;
+        return ExactResult();
+    }
+    ExactMaxCut solver(g, timeLimit);
+    return solver.solve(seed);
+}
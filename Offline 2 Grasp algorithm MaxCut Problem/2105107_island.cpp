@@ -0,0 +1,106 @@
+#include "2105107_maxcut.hpp"
+#include "2105107_island.hpp"
+#include <sys/wait.h>
+#include <csignal>
+
+// Island-model GRASP: forks one process per island against the same graph.
+// Usage: island <graph.rud> [islands] [seconds] [crash-island]
+// crash-island makes that island abort halfway through its budget, in the middle of writing its
+// slot, to check the others skip the torn slot and carry on exchanging.
+// Exits 1 if any other island dies or fails, or no island leaves an elite; 2 on bad arguments or input.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <graph.rud> [islands] [seconds] [crash-island]" << endl;
+        return 1;
+    }
+    string filename = argv[1];
+    int islands = argc > 2 ? atoi(argv[2]) : 4;
+    IslandConfig config;
+    config.seconds = argc > 3 ? atof(argv[3]) : 10;
+    int crashIsland = argc > 4 ? atoi(argv[4]) : -1;
+    if (islands < 1 || !(config.seconds > 0)) {
+        cerr << "islands must be at least 1 and seconds positive" << endl;
+        return 2;
+    }
+
+    // Load before forking, so a bad graph is reported once rather than crashing every island
+    Graph g(1);
+    try {
+        g = readGraphFromFile(filename);
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+    g.releaseEdges();
+    string segment = "/maxcut_islands_" + to_string(getpid());
+    EliteExchange exchange;
+    if (!exchange.create(segment, islands, g.V)) {
+        cerr << "Could not create shared memory segment " << segment << endl;
+        return 1;
+    }
+
+    srand(time(0));
+    vector<pid_t> children;
+    for (int island = 0; island < islands; island++) {
+        unsigned seed = rand();
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            IslandConfig own = config;
+            if (island == crashIsland) own.crashAfter = own.seconds / 2;
+            IslandResult result = runIsland(g, exchange, island, own, seed);
+            cout << "Island " << island << " finished with cut " << result.bestWeight << " after "
+                 << result.relinks << " relinks, " << result.skippedReads << " skipped reads" << endl;
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+
+    // The crash island is expected to die; any other island that does not exit cleanly is a failure
+    int failures = islands - (int)children.size();  // never forked
+    for (int island = 0; island < (int)children.size(); island++) {
+        int status;
+        if (waitpid(children[island], &status, 0) < 0) {
+            perror("waitpid");
+            failures++;
+            continue;
+        }
+        bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (WIFSIGNALED(status))
+            cout << "Island " << island << " died with signal " << WTERMSIG(status) << (island == crashIsland ? " (as asked)" : "") << endl;
+        else if (!clean)
+            cout << "Island " << island << " exited with status " << WEXITSTATUS(status) << endl;
+        if (!clean && island != crashIsland) failures++;
+    }
+
+    // Collect the elites, including those left behind by dead islands
+    vector<signed char> side(g.V + 1, -1);
+    long long bestWeight = -1;
+    int bestIsland = -1;
+    for (int island = 0; island < islands; island++) {
+        long long weight;
+        if (!exchange.read(island, side, weight)) {
+            if (exchange.silenceMillis(island) < 0) cout << "Island " << island << ": no elite published" << endl;
+            else cout << "Island " << island << ": slot left mid-write, ignored" << endl;
+            continue;
+        }
+        cout << "Island " << island << ": elite cut " << weight << endl;
+        if (weight > bestWeight) {
+            bestWeight = weight;
+            bestIsland = island;
+        }
+    }
+    if (bestIsland < 0) {
+        cout << "No island left an elite" << endl;
+        return 1;
+    }
+    cout << "Best cut " << bestWeight << " from island " << bestIsland << endl;
+    if (failures > 0) {
+        cout << failures << " island(s) failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Shared-memory elite exchange for island-model GRASP.
+// One slot per island; only its island writes it, guarded by a sequence counter
+// (odd while a write is in progress), so readers never block and a process that
+// dies mid-write only leaves its own slot unreadable.
+class EliteExchange {
+public:
+    ~EliteExchange() { close(); }
+
+    // Create and size a new segment; the creator unlinks it on close
+    bool create(const string& segmentName, int islands, int V) {
+        name = segmentName;
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return false;
+        size_t slotBytes = (sizeof(SlotHeader) + V + 63) / 64 * 64;
+        bytes = sizeof(Header) + slotBytes * islands;
+        if (ftruncate(fd, bytes) != 0 || !map(fd)) {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        ::close(fd);
+        header()->islands = islands;
+        header()->V = V;
+        header()->slotBytes = slotBytes;
+        for (int i = 0; i < islands; i++) new (slot(i)) SlotHeader();
+        header()->magic.store(MAGIC, memory_order_release);
+        owner = true;
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(base, bytes);
+        if (owner) shm_unlink(name.c_str());
+        base = nullptr;
+        owner = false;
+    }
+
+    int islands() const { return header()->islands; }
+
+    // dieMidWrite aborts the process halfway through the copy, leaving the slot torn (for testing)
+    void publish(int island, const vector<signed char>& side, long long weight, bool dieMidWrite = false) {
+        SlotHeader* s = slot(island);
+        uint64_t version = s->version.load(memory_order_relaxed);
+        s->version.store(version + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        s->weight = weight;
+        if (dieMidWrite) {
+            memcpy(sides(island), side.data() + 1, header()->V / 2);
+            abort();
+        }
+        memcpy(sides(island), side.data() + 1, header()->V);
+        s->heartbeat.store(chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count(), memory_order_relaxed);
+        s->version.store(version + 2, memory_order_release);
+    }
+
+    // Copy another island's elite into side; false if it has none yet or stays mid-write
+    bool read(int island, vector<signed char>& side, long long& weight) const {
+        const SlotHeader* s = slot(island);
+        for (int attempt = 0; attempt < 8; attempt++) {
+            uint64_t before = s->version.load(memory_order_acquire);
+            if (before == 0) return false;
+            if (before & 1) continue;
+            weight = s->weight;
+            memcpy(side.data() + 1, sides(island), header()->V);
+            atomic_thread_fence(memory_order_acquire);
+            if (s->version.load(memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+    // Milliseconds since the island last published, -1 if it never did
+    long long silenceMillis(int island) const {
+        const SlotHeader* s = slot(island);
+        if (s->version.load(memory_order_acquire) == 0) return -1;
+        long long now = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+        return now - s->heartbeat.load(memory_order_relaxed);
+    }
+
+private:
+    static const uint32_t MAGIC = 0x4d435558;  // "MCUX"
+
+    struct Header {
+        atomic<uint32_t> magic{0};
+        int islands = 0, V = 0;
+        size_t slotBytes = 0;
+    };
+    struct SlotHeader {
+        atomic<uint64_t> version{0};
+        atomic<long long> heartbeat{0};
+        long long weight = -1;
+    };
+
+    bool map(int fd) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        base = p;
+        return true;
+    }
+    Header* header() const { return static_cast<Header*>(base); }
+    SlotHeader* slot(int i) const {
+        return reinterpret_cast<SlotHeader*>(static_cast<char*>(base) + sizeof(Header) + header()->slotBytes * i);
+    }
+    signed char* sides(int i) const { return reinterpret_cast<signed char*>(slot(i) + 1); }
+
+    string name;
+    void* base = nullptr;
+    size_t bytes = 0;
+    bool owner = false;
+};
+
+// Path relinking from ws.side towards guide: repeatedly flip the differing vertex with
+// the best gain and keep the best partition met on the way in ws.side.
+// A partition and its complement are the same cut, so the walk heads for whichever is closer.
+void pathRelink(MaxCutWorkspace& ws, const vector<signed char>& guide) {
+    const Graph& g = ws.g;
+    vector<int> diff;
+    for (int v = 1; v <= g.V; v++)
+        if (ws.side[v] != guide[v]) diff.push_back(v);
+    if (2 * (int)diff.size() > g.V) {
+        diff.clear();
+        for (int v = 1; v <= g.V; v++)
+            if (ws.side[v] == guide[v]) diff.push_back(v);
+    }
+
+    vector<int> path;
+    long long bestWeight = ws.cutWeight;
+    size_t bestLength = 0;
+    while (!diff.empty()) {
+        size_t pick = 0;
+        for (size_t i = 1; i < diff.size(); i++)
+            if (ws.gain[diff[i]] > ws.gain[diff[pick]]) pick = i;
+        int v = diff[pick];
+        diff[pick] = diff.back();
+        diff.pop_back();
+        flipVertex(ws, v);
+        path.push_back(v);
+        if (ws.cutWeight > bestWeight) {
+            bestWeight = ws.cutWeight;
+            bestLength = path.size();
+        }
+    }
+    // Walk back to the best point on the path
+    for (size_t i = path.size(); i > bestLength; i--) flipVertex(ws, path[i - 1]);
+}
+
+struct IslandConfig {
+    double seconds = 10;    // wall-clock budget
+    int exchangeEvery = 5;  // GRASP iterations between publish / relink rounds
+    double alpha = 0.75;
+    double crashAfter = -1; // testing: abort in the middle of a publish after this many seconds
+};
+
+struct IslandResult {
+    long long bestWeight = -1;
+    int relinks = 0;        // exchange rounds that read another island's elite
+    int skippedReads = 0;   // exchange rounds whose chosen slot was empty or mid-write
+};
+
+// One island: GRASP that periodically publishes its best and relinks towards another
+// island's elite. Islands that never published or are mid-write are skipped, so a dead
+// island only stops contributing.
+IslandResult runIsland(const Graph& g, EliteExchange& exchange, int island, IslandConfig config, unsigned seed) {
+    MaxCutWorkspace ws(g);
+    mt19937 rng(seed);
+    vector<signed char> guide(g.V + 1, -1);
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::duration<double>(config.seconds);
+    auto crashTime = start + chrono::duration<double>(config.crashAfter);
+    long long lastPublished = -1;
+    IslandResult result;
+
+    for (int iteration = 1; chrono::steady_clock::now() < deadline; iteration++) {
+        semiGreedyConstruct(ws, config.alpha, rng);
+        localSearch(ws);
+
+        if (iteration % config.exchangeEvery == 0 && exchange.islands() > 1) {
+            // Relink from the fresh local optimum towards a random other island's elite
+            int other = rng() % (exchange.islands() - 1);
+            if (other >= island) other++;
+            long long otherWeight;
+            if (exchange.read(other, guide, otherWeight)) {
+                pathRelink(ws, guide);
+                localSearch(ws);
+                result.relinks++;
+            } else {
+                result.skippedReads++;
+            }
+        }
+
+        if (ws.cutWeight > ws.bestWeight) ws.keepAsBest();
+
+        bool crash = config.crashAfter >= 0 && chrono::steady_clock::now() >= crashTime;
+        if (iteration % config.exchangeEvery == 0 && (ws.bestWeight > lastPublished || crash)) {
+            exchange.publish(island, ws.bestSide, ws.bestWeight, crash);
+            lastPublished = ws.bestWeight;
+        }
+    }
+    if (ws.bestWeight > lastPublished) exchange.publish(island, ws.bestSide, ws.bestWeight);
+    result.bestWeight = ws.bestWeight;
+    return result;
+}
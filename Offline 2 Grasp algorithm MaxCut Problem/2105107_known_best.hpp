@@ -0,0 +1,36 @@
+#pragma once
+
+//hardcode known best
+int giveKnownbest(int graphNum) {
+    switch (graphNum) {
+    //     unordered_map<string, int> knownBest = {
+    // {"G1", 12078}, {"G2", 12084}, {"G3", 12077}, {"G11", 627}, {"G12", 621}, {"G13", 645}, {"G14", 3187}, {"G15", 3169}, {"G16", 3172}, {"G22", 14123}, {"G23", 14129}, {"G24", 14131}, {"G32", 1560}, {"G33", 1537}, {"G34", 1541}, {"G35", 8000}, {"G36", 7996}, {"G37", 8009}, {"G43", 7027}, {"G44", 7022}, {"G45", 7020}, {"G48", 6000}, {"G49", 6000}, {"G50", 5988}};
+        case 1: return 12078;
+        case 2: return 12084;
+        case 3: return 12077;
+        case 11: return 627;
+        //complete all
+        case 12: return 621;
+        case 13: return 645;
+        case 14: return 3187;
+        case 15: return 3169;
+        case 16: return 3172;
+        case 22: return 14123;
+        case 23: return 14129;
+        case 24: return 14131;
+        case 32: return 1560;
+        case 33: return 1537;
+        case 34: return 1541;
+        case 35: return 8000;
+        case 36: return 7996;
+        case 37: return 8009;
+        case 43: return 7027;
+        case 44: return 7022;
+        case 45: return 7020;
+        case 48: return 6000;
+        case 49: return 6000;
+        case 50: return 5988;
+        default: return -1;  // Unknown graph number
+
+    }
+}
@@ -0,0 +1,226 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <cmath>
+
+// Large-neighbourhood search (iterated greedy) for Max-Cut.
+// Each step unassigns a neighbourhood of the current partition, reassigns it with the
+// semi-greedy rule, improves locally around the change and then accepts or rolls back.
+
+enum class LNSNeighbourhood {
+    Random,    // uniformly random vertices
+    BFSBall,   // breadth-first ball around a random vertex
+    Conflict   // ball around the highest-gain (least settled) vertex of a random sample
+};
+
+enum class LNSAcceptance {
+    BetterOrEqual,  // keep the new partition unless it cuts less
+    Annealing,      // also keep worse ones with probability exp(delta / T)
+    Always          // random walk; the best is still tracked
+};
+
+struct LNSConfig {
+    double seconds = 5;
+    double destroyFraction = 0.05;  // share of vertices unassigned per step
+    double alpha = 0.75;            // semi-greedy RCL threshold for the repair
+    LNSNeighbourhood neighbourhood = LNSNeighbourhood::BFSBall;
+    LNSAcceptance acceptance = LNSAcceptance::BetterOrEqual;
+    double startTemperature = 2.0;  // annealing temperature in cut-weight units
+    double cooling = 0.9995;        // per step
+};
+
+struct LNSStats {
+    long long steps = 0, accepted = 0, improvements = 0;
+    size_t peakBytes = 0;  // workspace and step buffers
+};
+
+// Scratch buffers for the LNS steps, allocated once per graph
+struct LNSBuffers {
+    vector<int> chosen, order, flipLog, worklist;
+    vector<signed char> oldSide;
+    vector<char> marked, queued;
+
+    explicit LNSBuffers(int V) : oldSide(V + 1, -1), marked(V + 1, 0), queued(V + 1, 0) {
+        order.resize(V);
+        for (int v = 1; v <= V; v++) order[v - 1] = v;
+        chosen.reserve(V);
+        flipLog.reserve(V);
+        worklist.reserve(V);
+    }
+
+    size_t bytes() const {
+        return vectorBytes(chosen) + vectorBytes(order) + vectorBytes(flipLog) + vectorBytes(worklist) + vectorBytes(oldSide) +
+               vectorBytes(marked) + vectorBytes(queued);
+    }
+};
+
+// Pick `count` vertices into buf.chosen
+void chooseNeighbourhood(const MaxCutWorkspace& ws, LNSBuffers& buf, int count, LNSNeighbourhood kind, mt19937& rng) {
+    const Graph& g = ws.g;
+    buf.chosen.clear();
+    if (kind == LNSNeighbourhood::Random) {
+        for (int i = 0; i < count; i++) {
+            int j = i + rng() % (g.V - i);
+            swap(buf.order[i], buf.order[j]);
+            buf.chosen.push_back(buf.order[i]);
+        }
+    } else {
+        // BFS ball; restart from another random vertex if the component runs out
+        while ((int)buf.chosen.size() < count) {
+            int start = rng() % g.V + 1;
+            if (kind == LNSNeighbourhood::Conflict) {
+                for (int sample = 0; sample < 32; sample++) {
+                    int v = rng() % g.V + 1;
+                    if (!buf.marked[v] && (buf.marked[start] || ws.gain[v] > ws.gain[start])) start = v;
+                }
+            }
+            if (buf.marked[start]) continue;
+            size_t head = buf.chosen.size();
+            buf.marked[start] = 1;
+            buf.chosen.push_back(start);
+            while (head < buf.chosen.size() && (int)buf.chosen.size() < count) {
+                int v = buf.chosen[head++];
+                for (int k = g.offset[v]; k < g.offset[v + 1] && (int)buf.chosen.size() < count; k++) {
+                    int u = g.adjVertex[k];
+                    if (!buf.marked[u]) {
+                        buf.marked[u] = 1;
+                        buf.chosen.push_back(u);
+                    }
+                }
+            }
+        }
+    }
+    for (int v : buf.chosen) buf.marked[v] = 0;
+}
+
+template <typename Weights>
+void loggedFlip(MaxCutWorkspace& ws, LNSBuffers& buf, int v, Weights w) {
+    flipVertex(ws, v, w);
+    buf.flipLog.push_back(v);
+}
+
+// Destroy and repair buf.chosen, then local search from the changed region.
+// Every flip is logged so a rejected step can be rolled back exactly.
+template <typename Weights>
+void lnsStep(MaxCutWorkspace& ws, LNSBuffers& buf, double alpha, mt19937& rng, Weights w) {
+    const Graph& g = ws.g;
+    buf.flipLog.clear();
+
+    // Step 1: Unassign the neighbourhood, remembering where each vertex was
+    ws.candidates.clear();
+    for (int v : buf.chosen) {
+        buf.oldSide[v] = ws.side[v];
+        if (ws.side[v] == 1) ws.hash ^= ws.zobrist[v];
+        ws.side[v] = -1;
+        ws.position[v] = ws.candidates.size();
+        ws.candidates.push_back(v);
+    }
+    for (int v : buf.chosen) {
+        ws.sigmaX[v] = ws.sigmaY[v] = 0;
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int u = g.adjVertex[k];
+            if (ws.side[u] == 1) ws.sigmaX[v] += w[k];
+            else if (ws.side[u] == 0) ws.sigmaY[v] += w[k];
+        }
+    }
+
+    // Step 2: Reassign it with the semi-greedy rule
+    semiGreedyComplete(ws, alpha, rng, w);
+
+    // Step 3: Put the old sides back and replay the changes as flips, which keeps gains current
+    for (int v : buf.chosen) {
+        if (ws.side[v] != buf.oldSide[v]) {
+            ws.side[v] = buf.oldSide[v];
+            ws.hash ^= ws.zobrist[v];
+            buf.worklist.push_back(v);
+        }
+    }
+    for (int v : buf.worklist) loggedFlip(ws, buf, v, w);
+
+    // Step 4: Local search seeded with the neighbourhood, spreading to neighbours of flips
+    buf.worklist.clear();
+    for (int v : buf.chosen) {
+        if (ws.gain[v] > 0) {
+            buf.queued[v] = 1;
+            buf.worklist.push_back(v);
+        }
+    }
+    for (int v : buf.flipLog) {
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int u = g.adjVertex[k];
+            if (!buf.queued[u] && ws.gain[u] > 0) {
+                buf.queued[u] = 1;
+                buf.worklist.push_back(u);
+            }
+        }
+    }
+    while (!buf.worklist.empty()) {
+        int v = buf.worklist.back();
+        buf.worklist.pop_back();
+        buf.queued[v] = 0;
+        if (ws.gain[v] <= 0) continue;
+        loggedFlip(ws, buf, v, w);
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int u = g.adjVertex[k];
+            if (!buf.queued[u] && ws.gain[u] > 0) {
+                buf.queued[u] = 1;
+                buf.worklist.push_back(u);
+            }
+        }
+    }
+}
+
+// Run LNS from ws.bestSide (or from a fresh GRASP construction if there is no best yet)
+// until the time budget runs out. The best partition found is left in ws.bestSide.
+template <typename Weights>
+LNSStats largeNeighbourhoodSearch(MaxCutWorkspace& ws, const LNSConfig& config, mt19937& rng, Weights w) {
+    const Graph& g = ws.g;
+    LNSStats stats;
+    LNSBuffers buf(g.V);
+
+    // Step 1: The current solution starts as a copy of the best
+    if (ws.bestWeight < 0) {
+        semiGreedyConstruct(ws, config.alpha, rng);
+        localSearch(ws, w);
+        ws.keepAsBest();
+    }
+    ws.side = ws.bestSide;
+    computeGains(ws);
+
+    int count = max(1, min(g.V, (int)(config.destroyFraction * g.V)));
+    double temperature = config.startTemperature;
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    auto deadline = chrono::steady_clock::now() + chrono::duration<double>(config.seconds);
+
+    while (chrono::steady_clock::now() < deadline) {
+        stats.steps++;
+        long long before = ws.cutWeight;
+        chooseNeighbourhood(ws, buf, count, config.neighbourhood, rng);
+        lnsStep(ws, buf, config.alpha, rng, w);
+        long long delta = ws.cutWeight - before;
+
+        // Step 2: Accept, or roll the logged flips back in reverse
+        bool accept = delta >= 0 || config.acceptance == LNSAcceptance::Always ||
+                      (config.acceptance == LNSAcceptance::Annealing && temperature > 0 && unit(rng) < exp(delta / temperature));
+        if (accept) {
+            stats.accepted++;
+        } else {
+            for (size_t i = buf.flipLog.size(); i > 0; i--) flipVertex(ws, buf.flipLog[i - 1], w);
+        }
+        temperature *= config.cooling;
+
+        // Step 3: Track the best; copying is fine here since improvements are rare
+        if (ws.cutWeight > ws.bestWeight) {
+            stats.improvements++;
+            ws.bestWeight = ws.cutWeight;
+            copy(ws.side.begin(), ws.side.end(), ws.bestSide.begin());
+        }
+    }
+    stats.peakBytes = ws.bytes() + buf.bytes();
+    return stats;
+}
+
+LNSStats largeNeighbourhoodSearch(MaxCutWorkspace& ws, const LNSConfig& config, mt19937& rng) {
+    LNSStats stats;
+    withWeights(ws.g, [&](auto weights) { stats = largeNeighbourhoodSearch(ws, config, rng, weights); });
+    return stats;
+}
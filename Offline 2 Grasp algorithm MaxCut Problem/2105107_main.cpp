@@ -1,23 +1,28 @@
 
 #include "2105107_maxcut.hpp"
+#include "2105107_spectral.hpp"
+#include "2105107_pipeline.hpp"
+#include "2105107_parallel_search.hpp"
+#include "2105107_exact.hpp"
+#include "2105107_vns.hpp"
+#include "2105107_memory.hpp"
 
 
 int main() {
+    TraceSession trace;  // MAXCUT_TRACE=<file.json> records a timeline of the run
     srand(time(0));
     auto start = chrono::high_resolution_clock::now();
 
     freopen("in.txt", "r", stdin);
     freopen("out.txt", "w", stdout);
-    int V, E;
     cout << "Enter number of vertices and edges: ";
-    cin >> V >> E;
-
-    Graph g(V);
     cout << "Enter edges (u v weight):" << endl;
-    for (int i = 0; i < E; i++) {
-        int u, v, w;
-        cin >> u >> v >> w;
-        g.addEdge(u, v, w);
+    Graph g(1);
+    try {
+        g = readGraph(cin, "in.txt");
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return 2;
     }
 
     // Randomized
@@ -46,6 +51,26 @@ int main() {
     cout << "\nLocal search Max-Cut (α = " << alpha << "):\nunordered_set X: "; for (int v : SX_final) cout << v << " "; cout << "\nunordered_set Y: "; for (int v : SY_final) cout << v << " ";
     cout << "\nAfter Local Search: " << localImprovedWeight << endl;
 
+    // Parallel Local Search: one colour class of vertices flipped at a time
+    GraphColoring coloring = greedyColoring(g);
+    MaxCutWorkspace ws(g);
+    setsToSide(GX, GY, ws.side);
+    computeGains(ws);
+    int parallelRounds = parallelLocalSearch(ws, coloring);
+    cout << "\nParallel Local Search (" << coloring.classes.size() << " colour classes, " << omp_get_max_threads() << " threads):";
+    cout << "\nRounds: " << parallelRounds << "\nAfter Parallel Local Search: " << ws.cutWeight << endl;
+
+    // Spectral
+    mt19937 spectralRng(rand());
+    SpectralResult spectral = spectralMaxCut(g, spectralRng);
+    auto [spectralPartition, spectralIter] = localSearchMaxCut(g, spectral.X, spectral.Y);
+    int spectralWeight = computeCutWeight(g, spectralPartition.first, spectralPartition.second);
+    cout << "\nSpectral Max-Cut (" << spectral.iterations << " Lanczos steps):";
+    cout << "\nRounded Cut Weight: " << computeCutWeight(g, spectral.X, spectral.Y);
+    cout << "\nAfter Local Search: " << spectralWeight;
+    cout << "\nPositive Weight Bound: " << spectral.positiveWeightBound;
+    cout << "\nSpectral Estimate: " << spectral.estimate << " (Lanczos, not a bound)" << endl;
+
     // GRASP
     cout << "\nGRASP Max-Cut (α = " << alpha << "):\n";
     int maxIterations = 50;
@@ -54,6 +79,41 @@ int main() {
     cout << "\nGRASP Max-Cut Partition:\nunordered_set X: "; for (int v : GRASP_X) cout << v << " "; cout << "\nunordered_set Y: "; for (int v : GRASP_Y) cout << v << " ";
     cout << "\nGRASP Cut Weight: " << graspWeight << endl;
 
+    // GRASP with variable neighbourhood search (1-flip, edge 2-flip, swap shakes) as improvement
+    MaxCutWorkspace vnsWs(g);
+    mt19937 vnsRng(rand());
+    GRASPStats vnsStats = vnsGRASP(vnsWs, maxIterations, alpha, vnsRng);
+    cout << "\nGRASP + VNS Cut Weight: " << vnsWs.bestWeight << " (" << vnsStats.iterations << " iterations)" << endl;
+
+    // Exact: branch and bound, seeded with the GRASP partition; only for small graphs
+    if (g.V <= maxExactVertices) {
+        vector<signed char> graspSide(g.V + 1, -1);
+        setsToSide(GRASP_X, GRASP_Y, graspSide);
+        ExactResult exact = exactMaxCut(g, 60, &graspSide);
+        cout << "\nExact Max-Cut (" << (exact.proven ? "proven optimum" : "time limit reached") << "): " << exact.cut;
+        cout << "\nNodes: " << exact.nodes << ", seconds: " << exact.seconds;
+        cout << "\nGRASP gap: " << exact.cut - graspWeight << endl;
+    } else {
+        cout << "\nExact Max-Cut skipped (" << g.V << " vertices, at most " << maxExactVertices << ")" << endl;
+    }
+
+    // Pipelined GRASP: construction and local search on separate threads
+    PipelineConfig config;
+    config.producers = 1;
+    config.consumers = max(1, (int)thread::hardware_concurrency() - 1);
+    PipelineStats stats;
+    auto [PX, PY] = pipelinedGRASP(g, maxIterations, alpha, config, &stats);
+    cout << "\nPipelined GRASP (" << config.producers << " producers, " << config.consumers << " consumers)";
+    cout << "\nPipelined GRASP Cut Weight: " << computeCutWeight(g, PX, PY);
+    cout << "\nConstruction / Local Search seconds: " << stats.constructionSeconds << " / " << stats.localSearchSeconds;
+    cout << "\nProducer / Consumer stalls: " << stats.producerStalls << " / " << stats.consumerStalls << endl;
+
+    // Memory footprints
+    cout << "\nGraph memory: " << footprint(g.bytes(), g);
+    cout << "\nSpectral memory: " << footprint(spectral.peakBytes, g);
+    cout << "\nGRASP + VNS memory: " << footprint(vnsStats.peakBytes, g);
+    cout << "\nPeak RSS: " << peakRSSBytes() / 1048576.0 << " MB" << endl;
+
     // Calculate the total time
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration<double>(end - start);
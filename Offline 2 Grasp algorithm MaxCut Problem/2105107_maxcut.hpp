@@ -1,3 +1,4 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <unordered_set>
@@ -8,19 +9,87 @@
 #include <fstream>
 #include <chrono>
 #include <omp.h>
+#include <climits>
+#include <cstdint>
+#include <unordered_map>
+#include <stdexcept>
+#include "2105107_trace.hpp"
+#if defined(__AVX2__) || defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+// Heap bytes held by a vector, for the memory footprint reports
+template <typename T>
+size_t vectorBytes(const vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
 class Edge {
 public:
     int u, v, weight;
     Edge(int u, int v, int weight) : u(u), v(v), weight(weight) {}
 };
 
+// How CSR weights are stored, chosen by buildCSR from the data.
+// Unit stores no weight array, Int8 one byte per entry, Dict8 one byte per entry indexing
+// weightDict (at most 256 distinct weights, any of them outside int8), Int32 the full int.
+enum class WeightClass { Unit, Int8, Dict8, Int32 };
+
+// Neighbour lists as varint-coded gaps between sorted neighbours, usually one or two bytes per
+// CSR entry instead of four. A storage option for graphs held between solves; the kernels index
+// adjVertex directly, so a packed graph must be unpacked before solving.
+struct PackedNeighbours {
+    vector<uint32_t> start;  // byte offset of each vertex's list, V + 2 entries; empty when not packed
+    vector<uint8_t> bytes;
+};
+
+// A toroidal grid numbered row by row: vertex r * cols + c + 1 sits in cell i = r * cols + c and is
+// joined to its right and lower neighbours, both wrapping around. Edge weights are stored per cell
+// in the arrays matching the graph's weightClass (none for Unit).
+struct GridLayout {
+    int rows = 0, cols = 0;        // 0 when the graph is not a toroidal grid
+    vector<int> right, down;       // weight from cell i to its right / lower neighbour
+    vector<int8_t> right8, down8;
+};
+
+// Adjacency as bitsets, one per vertex and distinct edge weight: bit u of row (c, v) is set when
+// u and v are joined by an edge of weight weights[c]. Vertices keep their 1-based numbers as bit
+// indices. Only worth it for dense graphs, where a row is shorter than the neighbour list.
+struct DenseLayout {
+    int words = 0;           // 64-bit words per row, 0 when not built
+    vector<int> weights;     // the distinct edge weights
+    vector<uint64_t> bits;   // row (c, v) starts at (c * (V + 1) + v) * words
+    vector<int> degree;      // degree[c * (V + 1) + v]: popcount of row (c, v)
+
+    const uint64_t* row(int c, int v, int V) const { return bits.data() + ((size_t)c * (V + 1) + v) * words; }
+};
+
 class Graph {
 public:
     int V;
-    vector<Edge> edges;
+    vector<Edge> edges;  // as added; releaseEdges frees it once the CSR is built
+
+    // CSR adjacency (filled by buildCSR): neighbours of v are adjVertex[offset[v] .. offset[v + 1]).
+    // Their weights live in adjWeight8 or adjWeight depending on weightClass; read them through withWeights.
+    // Indices are 32-bit throughout, so the CSR holds fewer than 2^31 entries.
+    vector<int> offset, adjVertex, adjWeight;
+    vector<int8_t> adjWeight8;
+    vector<uint8_t> adjWeightIndex;  // Dict8: index into weightDict per entry
+    vector<int> weightDict;
+    WeightClass weightClass = WeightClass::Int32;
+    bool wideSums = false;  // some weighted degree does not fit in an int, accumulate in long long
+    GridLayout grid;        // filled by buildCSR when the edges form a toroidal grid
+    DenseLayout dense;      // filled by buildCSR when the graph is dense enough, see denseThreshold
+    PackedNeighbours packed;  // filled by packNeighbours, which empties adjVertex
+
+    // Edge densities from which buildCSR also builds the bitset layout, used for gains and cut
+    // evaluation, and from which local search flips through it too (a flip visits every
+    // neighbour either way, so it pays off later). 2105107_dense_bench.cpp measures both crossovers.
+    static constexpr double denseThreshold = 0.03;
+    static constexpr double denseSearchThreshold = 0.1;
+    static const int maxDenseWeights = 4;
 
     Graph(int vertices) : V(vertices) {}
 
@@ -28,19 +97,365 @@ public:
         edges.emplace_back(u, v, weight);
     }
 
-    Edge getMaxWeightEdge() const {
-        return *max_element(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
-            return a.weight < b.weight;
-        });
+    // Build the CSR arrays from the edge list; call once after all edges are added
+    void buildCSR() {
+        offset.assign(V + 2, 0);
+        weightClass = WeightClass::Unit;
+        for (const Edge& e : edges) {
+            offset[e.u + 1]++;
+            offset[e.v + 1]++;
+            if (e.weight < INT8_MIN || e.weight > INT8_MAX) weightClass = WeightClass::Int32;
+            else if (e.weight != 1 && weightClass == WeightClass::Unit) weightClass = WeightClass::Int8;
+        }
+        for (int v = 1; v <= V + 1; v++) offset[v] += offset[v - 1];
+
+        // Wide weights with few distinct values go into a dictionary
+        unordered_map<int, int> dictIndex;
+        weightDict.clear();
+        if (weightClass == WeightClass::Int32) {
+            weightClass = WeightClass::Dict8;
+            for (const Edge& e : edges) {
+                if (dictIndex.count(e.weight)) continue;
+                if (weightDict.size() == 256) {
+                    weightClass = WeightClass::Int32;
+                    weightDict.clear();
+                    break;
+                }
+                dictIndex[e.weight] = weightDict.size();
+                weightDict.push_back(e.weight);
+            }
+        }
+
+        vector<long long> absDegree(V + 1, 0);
+        for (const Edge& e : edges) {
+            absDegree[e.u] += abs((long long)e.weight);
+            absDegree[e.v] += abs((long long)e.weight);
+        }
+        wideSums = !absDegree.empty() && *max_element(absDegree.begin(), absDegree.end()) > INT_MAX / 4;
+
+        adjVertex.assign(2 * edges.size(), 0);
+        adjWeight.clear();
+        adjWeight8.clear();
+        adjWeightIndex.clear();
+        packed = PackedNeighbours();
+        if (weightClass == WeightClass::Int32) adjWeight.resize(2 * edges.size());
+        if (weightClass == WeightClass::Int8) adjWeight8.resize(2 * edges.size());
+        if (weightClass == WeightClass::Dict8) adjWeightIndex.resize(2 * edges.size());
+        vector<int> pos(offset.begin(), offset.end() - 1);
+        for (const Edge& e : edges) {
+            int a = pos[e.u]++, b = pos[e.v]++;
+            adjVertex[a] = e.v;
+            adjVertex[b] = e.u;
+            if (weightClass == WeightClass::Int32) adjWeight[a] = adjWeight[b] = e.weight;
+            if (weightClass == WeightClass::Int8) adjWeight8[a] = adjWeight8[b] = e.weight;
+            if (weightClass == WeightClass::Dict8) adjWeightIndex[a] = adjWeightIndex[b] = dictIndex[e.weight];
+        }
+        detectGrid();
+        dense = DenseLayout();
+        if (!isGrid() && density() >= denseThreshold) buildDense();
+    }
+
+    // Edge count, from the CSR once it is built so it survives releaseEdges
+    size_t edgeCount() const { return hasCSR() ? offset[V + 1] / 2 : edges.size(); }
+
+    double density() const { return V > 1 ? 2.0 * edgeCount() / ((double)V * (V - 1)) : 0; }
+
+    // Free the edge list (12 bytes per edge) after buildCSR; forEachEdge then walks the CSR,
+    // which must stay unpacked while it is used that way. No edges can be added afterwards.
+    void releaseEdges() {
+        if (hasCSR()) vector<Edge>().swap(edges);
+    }
+
+    bool hasCSR() const { return !offset.empty(); }
+    bool isPacked() const { return !packed.start.empty(); }
+    bool isGrid() const { return grid.rows > 0; }
+    bool isDense() const { return dense.words > 0; }
+
+    // Build the bitset layout regardless of density. Fails (leaving it empty) for self-loops,
+    // parallel edges, more than maxDenseWeights distinct weights or rows past 256 MB in total.
+    bool buildDense() {
+        dense = DenseLayout();
+        DenseLayout d;
+        for (const Edge& e : edges) {
+            if (find(d.weights.begin(), d.weights.end(), e.weight) == d.weights.end()) d.weights.push_back(e.weight);
+        }
+        d.words = (V + 64) / 64;
+        size_t rowWords = (size_t)d.weights.size() * (V + 1) * d.words;
+        if (d.weights.size() > maxDenseWeights || rowWords * 8 > (256u << 20)) return false;
+        d.bits.assign(rowWords, 0);
+        d.degree.assign(d.weights.size() * (V + 1), 0);
+        for (const Edge& e : edges) {
+            int c = find(d.weights.begin(), d.weights.end(), e.weight) - d.weights.begin();
+            uint64_t* rowU = d.bits.data() + ((size_t)c * (V + 1) + e.u) * d.words;
+            uint64_t* rowV = d.bits.data() + ((size_t)c * (V + 1) + e.v) * d.words;
+            if (e.u == e.v || (rowU[e.v / 64] >> (e.v % 64) & 1)) return false;
+            for (int other = 0; other < (int)d.weights.size(); other++) {
+                if (other != c && (d.row(other, e.u, V)[e.v / 64] >> (e.v % 64) & 1)) return false;
+            }
+            rowU[e.v / 64] |= 1ULL << (e.v % 64);
+            rowV[e.u / 64] |= 1ULL << (e.u % 64);
+            d.degree[c * (V + 1) + e.u]++;
+            d.degree[c * (V + 1) + e.v]++;
+        }
+        dense = move(d);
+        return true;
+    }
+
+    // Recognise a toroidal grid (as in the G-set's g11-g13, g32-g34, g48-g50) by trying every
+    // rows x cols shape; a mismatching edge rejects a shape early, so this stays close to O(E)
+    void detectGrid() {
+        grid = GridLayout();
+        if (V < 9 || edges.size() != 2 * (size_t)V) return;
+        for (int cols = 3; cols <= V / 3; cols++) {
+            if (V % cols == 0 && tryGrid(V / cols, cols)) return;
+        }
     }
+
+    // Sort every neighbour list (weights move along) and replace adjVertex by the packed gaps.
+    // Fails, changing nothing, if the packed lists would pass 4 GB.
+    bool packNeighbours() {
+        if (!hasCSR() || isPacked()) return false;
+
+        // Step 1: Sort each list by neighbour, permuting whichever weight array is in use
+        vector<int> order, scratch;
+        for (int v = 1; v <= V; v++) {
+            int begin = offset[v], end = offset[v + 1];
+            if (is_sorted(adjVertex.begin() + begin, adjVertex.begin() + end)) continue;
+            order.resize(end - begin);
+            for (int i = 0; i < end - begin; i++) order[i] = begin + i;
+            sort(order.begin(), order.end(), [&](int a, int b) { return adjVertex[a] < adjVertex[b]; });
+            auto permute = [&](auto& values) {
+                if (values.empty()) return;
+                scratch.resize(order.size());
+                for (size_t i = 0; i < order.size(); i++) scratch[i] = values[order[i]];
+                for (size_t i = 0; i < order.size(); i++) values[begin + i] = scratch[i];
+            };
+            permute(adjVertex);
+            permute(adjWeight);
+            permute(adjWeight8);
+            permute(adjWeightIndex);
+        }
+
+        // Step 2: Gaps from the previous neighbour (from 0 for the first), 7 bits per byte
+        PackedNeighbours p;
+        p.start.resize(V + 2);
+        for (int v = 0; v <= V + 1; v++) {
+            if (p.bytes.size() > UINT32_MAX) return false;
+            p.start[v] = p.bytes.size();
+            if (v == 0 || v > V) continue;
+            int previous = 0;
+            for (int k = offset[v]; k < offset[v + 1]; k++) {
+                uint32_t gap = adjVertex[k] - previous;
+                previous = adjVertex[k];
+                for (; gap >= 0x80; gap >>= 7) p.bytes.push_back((gap & 0x7F) | 0x80);
+                p.bytes.push_back(gap);
+            }
+        }
+        p.bytes.shrink_to_fit();
+        packed = move(p);
+        vector<int>().swap(adjVertex);
+        return true;
+    }
+
+    // Restore adjVertex from the packed lists (which stay sorted)
+    void unpackNeighbours() {
+        if (!isPacked()) return;
+        adjVertex.resize(offset[V + 1]);
+        for (int v = 1; v <= V; v++) {
+            const uint8_t* byte = packed.bytes.data() + packed.start[v];
+            int previous = 0;
+            for (int k = offset[v]; k < offset[v + 1]; k++) {
+                uint32_t gap = 0;
+                for (int shift = 0; ; shift += 7) {
+                    gap |= (uint32_t)(*byte & 0x7F) << shift;
+                    if (!(*byte++ & 0x80)) break;
+                }
+                previous += gap;
+                adjVertex[k] = previous;
+            }
+        }
+        packed = PackedNeighbours();
+    }
+
+    // Heap bytes of the edge list and every adjacency layout currently built
+    size_t bytes() const {
+        return vectorBytes(edges) + vectorBytes(offset) + vectorBytes(adjVertex) + vectorBytes(adjWeight) + vectorBytes(adjWeight8) +
+               vectorBytes(adjWeightIndex) + vectorBytes(weightDict) + vectorBytes(grid.right) + vectorBytes(grid.down) +
+               vectorBytes(grid.right8) + vectorBytes(grid.down8) + vectorBytes(dense.weights) + vectorBytes(dense.bits) +
+               vectorBytes(dense.degree) + vectorBytes(packed.start) + vectorBytes(packed.bytes);
+    }
+
+    Edge getMaxWeightEdge() const;
+
+private:
+    bool tryGrid(int rows, int cols) {
+        vector<long long> right(V, LLONG_MIN), down(V, LLONG_MIN);
+        for (const Edge& e : edges) {
+            int a = e.u - 1, b = e.v - 1;
+            int ra = a / cols, ca = a % cols, rb = b / cols, cb = b % cols;
+            long long* slot = nullptr;
+            if (ra == rb && (ca + 1) % cols == cb) slot = &right[a];
+            else if (ra == rb && (cb + 1) % cols == ca) slot = &right[b];
+            else if (ca == cb && (ra + 1) % rows == rb) slot = &down[a];
+            else if (ca == cb && (rb + 1) % rows == ra) slot = &down[b];
+            if (!slot || *slot != LLONG_MIN) return false;
+            *slot = e.weight;
+        }
+        grid.rows = rows;
+        grid.cols = cols;
+        if (weightClass == WeightClass::Int32 || weightClass == WeightClass::Dict8) {
+            grid.right.assign(right.begin(), right.end());
+            grid.down.assign(down.begin(), down.end());
+        }
+        if (weightClass == WeightClass::Int8) {
+            grid.right8.assign(right.begin(), right.end());
+            grid.down8.assign(down.begin(), down.end());
+        }
+        return true;
+    }
+
+};
+
+// Weight accessors for CSR entry k. Kernels are templated on these so each
+// weight class gets its own loop, with no per-edge branch on the storage type.
+struct UnitWeights {
+    int operator[](int) const { return 1; }
 };
 
+template <typename W>
+struct ArrayWeights {
+    const W* data;
+    int operator[](int k) const { return data[k]; }
+};
+
+struct DictWeights {
+    const uint8_t* index;
+    const int* dict;
+    int operator[](int k) const { return dict[index[k]]; }
+};
+
+// Call f(weights) with the accessor matching g.weightClass
+template <typename F>
+void withWeights(const Graph& g, F&& f) {
+    switch (g.weightClass) {
+        case WeightClass::Unit: f(UnitWeights{}); break;
+        case WeightClass::Int8: f(ArrayWeights<int8_t>{g.adjWeight8.data()}); break;
+        case WeightClass::Dict8: f(DictWeights{g.adjWeightIndex.data(), g.weightDict.data()}); break;
+        default: f(ArrayWeights<int>{g.adjWeight.data()}); break;
+    }
+}
+
+// Call f(u, v, weight) once per edge: from the edge list while the graph has one, otherwise from
+// the CSR, where an edge u-v appears in both lists and a self-loop twice in its vertex's list
+template <typename F>
+void forEachEdge(const Graph& g, F&& f) {
+    if (!g.edges.empty() || !g.hasCSR()) {
+        for (const Edge& e : g.edges) f(e.u, e.v, e.weight);
+        return;
+    }
+    withWeights(g, [&](auto weights) {
+        for (int u = 1; u <= g.V; u++) {
+            bool loopSeen = false;
+            for (int k = g.offset[u]; k < g.offset[u + 1]; k++) {
+                int v = g.adjVertex[k];
+                if (v == u) loopSeen = !loopSeen;
+                if (v > u || (v == u && loopSeen)) f(u, v, (int)weights[k]);
+            }
+        }
+    });
+}
+
+inline Edge Graph::getMaxWeightEdge() const {
+    Edge best(1, 1, INT_MIN);
+    forEachEdge(*this, [&](int u, int v, int weight) {
+        if (weight > best.weight) best = Edge(u, v, weight);
+    });
+    return best;
+}
+
+// Same, also passing a zero of the accumulator type per-vertex sums should use
+template <typename F>
+void withKernelTypes(const Graph& g, F&& f) {
+    withWeights(g, [&](auto weights) {
+        if (g.wideSums) f(weights, 0LL);
+        else f(weights, 0);
+    });
+}
+
+// Grid weight accessors for cell i, the stencil counterparts of UnitWeights / ArrayWeights
+struct UnitGridWeights {
+    int right(int) const { return 1; }
+    int down(int) const { return 1; }
+};
+
+template <typename W>
+struct ArrayGridWeights {
+    const W* rightData;
+    const W* downData;
+    int right(int i) const { return rightData[i]; }
+    int down(int i) const { return downData[i]; }
+};
+
+// withKernelTypes for the grid layout of g; Dict8 grids keep int weights per cell
+template <typename F>
+void withGridKernelTypes(const Graph& g, F&& f) {
+    auto call = [&](auto weights) {
+        if (g.wideSums) f(weights, 0LL);
+        else f(weights, 0);
+    };
+    switch (g.weightClass) {
+        case WeightClass::Unit: call(UnitGridWeights{}); break;
+        case WeightClass::Int8: call(ArrayGridWeights<int8_t>{g.grid.right8.data(), g.grid.down8.data()}); break;
+        default: call(ArrayGridWeights<int>{g.grid.right.data(), g.grid.down.data()}); break;
+    }
+}
+
+// Read a graph in .rud format ("V E" then E lines "u v weight") and build its CSR. source names
+// the input in error messages. Throws runtime_error unless V >= 1, E >= 0, all E edges are
+// present and every endpoint is in 1..V, since buildCSR indexes by endpoint unchecked.
+Graph readGraph(istream& in, const string& source) {
+    long long V, E;
+    if (!(in >> V >> E)) throw runtime_error(source + ": missing vertex and edge counts");
+    // The CSR uses int offsets with two entries per edge
+    if (V < 1 || V > INT_MAX - 2) throw runtime_error(source + ": vertex count " + to_string(V) + " out of range");
+    if (E < 0 || E > INT_MAX / 2) throw runtime_error(source + ": edge count " + to_string(E) + " out of range");
+
+    Graph g(V);
+    // Growing by doubling could leave up to half the edge list unused, so reserve it, but only
+    // once the input is seen to be long enough: an edge line takes at least 6 characters
+    streampos body = in.tellg();
+    if (body != streampos(-1) && in.seekg(0, ios::end)) {
+        long long remaining = in.tellg() - body;
+        in.seekg(body);
+        if (E * 6 - 1 > remaining) throw runtime_error(source + ": declares " + to_string(E) + " edges but is too short to hold them");
+        g.edges.reserve(E);
+    }
+    in.clear();
+    for (long long i = 1; i <= E; i++) {
+        int u, v, weight;
+        if (!(in >> u >> v >> weight)) throw runtime_error(source + ": edge " + to_string(i) + " of " + to_string(E) + " is missing or malformed");
+        if (u < 1 || u > V || v < 1 || v > V)
+            throw runtime_error(source + ": edge " + to_string(i) + " has an endpoint outside 1.." + to_string(V));
+        g.addEdge(u, v, weight);
+    }
+    g.buildCSR();
+    return g;
+}
+
+// Function to read the graph from a .rud file; throws runtime_error as readGraph does
+Graph readGraphFromFile(const string& filename) {
+    ifstream file(filename);
+    if (!file) throw runtime_error("cannot open " + filename);
+    return readGraph(file, filename);
+}
+
 int computeCutWeight(const Graph& g, const unordered_set<int>& X, const unordered_set<int>& Y) {
+    TraceScope trace("cut evaluation");
     int weight = 0;
-    for (const Edge& e : g.edges) {
-        if ((X.count(e.u) && Y.count(e.v)) || (X.count(e.v) && Y.count(e.u)))
-            weight += e.weight;
-    }
+    forEachEdge(g, [&](int u, int v, int w) {
+        if ((X.count(u) && Y.count(v)) || (X.count(v) && Y.count(u)))
+            weight += w;
+    });
     return weight;
 }
 
@@ -53,10 +468,10 @@ double randomizedMaxCut(const Graph& g, int n) {
             partition[v] = rand() % 2;
         }
         int cutWeight = 0;
-        for (const Edge& e : g.edges) {
-            if (partition[e.u] != partition[e.v])
-                cutWeight += e.weight;
-        }
+        forEachEdge(g, [&](int u, int v, int weight) {
+            if (partition[u] != partition[v])
+                cutWeight += weight;
+        });
         totalCutWeight += cutWeight;
     }
     return static_cast<double>(totalCutWeight) / n;
@@ -75,12 +490,12 @@ pair<unordered_set<int>, unordered_set<int>> greedyMaxCut(const Graph& g) {
     for (int z = 1; z <= g.V; z++) {
         if (assigned[z]) continue;
         int wX = 0, wY = 0;
-        for (const Edge& e : g.edges) {
-            if (e.u == z && Y.count(e.v)) wX += e.weight;
-            if (e.v == z && Y.count(e.u)) wX += e.weight;
-            if (e.u == z && X.count(e.v)) wY += e.weight;
-            if (e.v == z && X.count(e.u)) wY += e.weight;
-        }
+        forEachEdge(g, [&](int u, int v, int weight) {
+            if (u == z && Y.count(v)) wX += weight;
+            if (v == z && Y.count(u)) wX += weight;
+            if (u == z && X.count(v)) wY += weight;
+            if (v == z && X.count(u)) wY += weight;
+        });
         if (wX > wY) X.insert(z);
         else Y.insert(z);
         assigned[z] = true;
@@ -88,166 +503,600 @@ pair<unordered_set<int>, unordered_set<int>> greedyMaxCut(const Graph& g) {
     return {X, Y};
 }
 
-// Semi-Greedy Max-Cut
-pair<unordered_set<int>, unordered_set<int>> semiGreedyMaxCut(const Graph& g, double alpha) {
-    unordered_set<int> X, Y;
-    vector<bool> assigned(g.V + 1, false);
-
-    // Step 1: Start by selecting the edge with the maximum weight
-    Edge maxEdge = g.getMaxWeightEdge();
-    X.insert(maxEdge.u);
-    Y.insert(maxEdge.v);
-    assigned[maxEdge.u] = true;
-    assigned[maxEdge.v] = true;
+// Open-addressing set of 64-bit keys with a fixed capacity, so inserts never allocate.
+// 0 marks an empty slot; key 0 is stored as 1.
+class HashSet64 {
+public:
+    // Empty the set, growing it if needed so `expected` keys keep it at most half full
+    void reset(size_t expected) {
+        size_t size = 16;
+        while (size < 2 * expected + 2) size <<= 1;
+        if (slots.size() < size) slots.assign(size, 0);
+        else fill(slots.begin(), slots.end(), 0);
+        count = 0;
+    }
 
-    // Step 2: Create an adjacency list representation of the graph
-    vector<vector<pair<int, int>>> adj(g.V + 1);
-    for (const Edge& e : g.edges) {
-        adj[e.u].emplace_back(e.v, e.weight);
-        adj[e.v].emplace_back(e.u, e.weight);
+    // True if key was not in the set yet
+    bool insert(uint64_t key) {
+        if (key == 0) key = 1;
+        size_t mask = slots.size() - 1;
+        for (size_t i = (key * 0x9E3779B97F4A7C15ULL) >> 7 & mask; ; i = (i + 1) & mask) {
+            if (slots[i] == key) return false;
+            if (slots[i] == 0) {
+                if (2 * (count + 1) > slots.size()) return true;  // full: treat as new, do not store
+                slots[i] = key;
+                count++;
+                return true;
+            }
+        }
     }
 
-    // Step 3: Set up unassigned vertices
-    unordered_set<int> unassigned;
-    for (int i = 1; i <= g.V; i++) {
-        if (!assigned[i]) {
-            unassigned.insert(i);
+    bool contains(uint64_t key) const {
+        if (key == 0) key = 1;
+        size_t mask = slots.size() - 1;
+        for (size_t i = (key * 0x9E3779B97F4A7C15ULL) >> 7 & mask; ; i = (i + 1) & mask) {
+            if (slots[i] == key) return true;
+            if (slots[i] == 0) return false;
         }
     }
 
-    // Step 4: Continue until all vertices are assigned
-    while (!unassigned.empty()) {
-        vector<tuple<int, double, double>> candidates;
-        double w_min = 1e9;
-        double w_max = -1e9;
+    size_t bytes() const { return vectorBytes(slots); }
 
-        // Step 5: Calculate the greedy value for each unassigned vertex
-        for (int v : unassigned) {
-            double sigmaX = 0, sigmaY = 0;
+private:
+    vector<uint64_t> slots;
+    size_t count = 0;
+};
 
-            for (const auto& [neighbor, weight] : adj[v]) {
-                if (X.count(neighbor)) sigmaY += weight;
-                else if (Y.count(neighbor)) sigmaX += weight;
-            }
+// Everything one solve needs, allocated once per graph and reused across GRASP
+// iterations and algorithms. The graph must have at least one vertex and its CSR arrays built,
+// and not be packed; the constructor throws invalid_argument otherwise, which also covers the
+// set-based wrappers (semiGreedyMaxCut, localSearchMaxCut, GRASP on a Graph) built on it.
+// side[v] is 0 for X, 1 for Y and -1 while unassigned.
+class MaxCutWorkspace {
+public:
+    const Graph& g;
+    vector<signed char> side, bestSide;
+    vector<long long> gain;            // cut change if v switches side
+    vector<long long> sigmaX, sigmaY;  // construction: weight v would cut in X / in Y
+    vector<int> candidates, position;  // unassigned vertices and their index in candidates
+    vector<int> rcl;                   // restricted candidate list, as indices into candidates
+    long long cutWeight = 0, bestWeight = -1;
+    Edge maxEdge;
 
-            double greedy_val = max(sigmaX, sigmaY);
-            w_min = min(w_min, min(sigmaX, sigmaY));
-            w_max = max(w_max, greedy_val);
+    // Zobrist hash of side: XOR of zobrist[v] over the vertices in Y, kept current by every kernel
+    vector<uint64_t> zobrist;
+    uint64_t hash = 0, zobristAll = 0;
+    HashSet64 visited;  // partitions GRASP has already searched from or arrived at
+    vector<uint64_t> sideBits;  // dense kernels: side as a bitset of Y, rebuilt by each of them
 
-            candidates.push_back({v, sigmaX, sigmaY});
+    MaxCutWorkspace(const Graph& graph)
+        : g(solvable(graph)), side(graph.V + 1, -1), bestSide(graph.V + 1, -1), gain(graph.V + 1, 0),
+          sigmaX(graph.V + 1, 0), sigmaY(graph.V + 1, 0), position(graph.V + 1, -1),
+          maxEdge(graph.edgeCount() == 0 ? Edge(1, 1, 0) : graph.getMaxWeightEdge()), zobrist(graph.V + 1, 0) {
+        candidates.reserve(graph.V);
+        rcl.reserve(graph.V);
+        sideBits.assign(graph.dense.words, 0);
+        mt19937_64 keys(graph.V);
+        for (int v = 1; v <= graph.V; v++) {
+            zobrist[v] = keys();
+            zobristAll ^= zobrist[v];
         }
+    }
 
-        // Step 6: Calculate mu based on w_min and w_max
-        double mu = w_min + alpha * (w_max - w_min);
+    // The graph itself, once checked that the kernels can index it
+    static const Graph& solvable(const Graph& graph) {
+        if (graph.V < 1) throw invalid_argument("MaxCutWorkspace: graph has no vertices");
+        if (!graph.hasCSR()) throw invalid_argument("MaxCutWorkspace: call buildCSR() on the graph first");
+        if (graph.isPacked()) throw invalid_argument("MaxCutWorkspace: graph is packed, call unpackNeighbours() first");
+        return graph;
+    }
 
-        // Step 7: Build the Restricted Candidate List (RCL)
-        vector<tuple<int, double, double>> RCL;
-        for (auto &[v, sigmaX, sigmaY] : candidates) {
-            double greedy_val = max(sigmaX, sigmaY);
-            if (greedy_val >= mu) {
-                RCL.push_back({v, sigmaX, sigmaY});
-            }
-        }
+    // Heap bytes of the workspace, not counting the graph
+    size_t bytes() const {
+        return vectorBytes(side) + vectorBytes(bestSide) + vectorBytes(gain) + vectorBytes(sigmaX) + vectorBytes(sigmaY) +
+               vectorBytes(candidates) + vectorBytes(position) + vectorBytes(rcl) + vectorBytes(zobrist) + visited.bytes() +
+               vectorBytes(sideBits);
+    }
 
-        // Step 8: If RCL is empty, select the first candidate
-        if (RCL.empty()) {
-            RCL = candidates;
-        }
+    // Same value for a partition and its X/Y swap
+    uint64_t partitionHash() const { return min(hash, hash ^ zobristAll); }
 
-        // Step 9: Randomly select a candidate from RCL
-        int idx = rand() % RCL.size();
-        auto [v, sigmaX, sigmaY] = RCL[idx];
+    // Keep the current solution as the best one; the old best buffer becomes scratch
+    void keepAsBest() {
+        swap(side, bestSide);
+        bestWeight = cutWeight;
+    }
+};
 
-        // Step 10: Assign the chosen vertex to the set that maximizes the cut weight
-        if (sigmaX > sigmaY) {
-            X.insert(v);
-        } else {
-            Y.insert(v);
-        }
+unordered_set<int> sideToSet(const vector<signed char>& side, int which) {
+    unordered_set<int> S;
+    for (int v = 1; v < (int)side.size(); v++)
+        if (side[v] == which) S.insert(v);
+    return S;
+}
 
-        // Step 11: Mark the vertex as assigned
-        assigned[v] = true;
-        unassigned.erase(v);
+void setsToSide(const unordered_set<int>& X, const unordered_set<int>& Y, vector<signed char>& side) {
+    fill(side.begin(), side.end(), -1);
+    for (int v : X) side[v] = 0;
+    for (int v : Y) side[v] = 1;
+}
+
+// Fill gain[] and cutWeight from the current sides
+template <typename Acc, typename Weights>
+void computeGains(MaxCutWorkspace& ws, Weights w) {
+    const Graph& g = ws.g;
+    long long cut = 0;
+    ws.hash = 0;
+    for (int v = 1; v <= g.V; v++) {
+        if (ws.side[v] == 1) ws.hash ^= ws.zobrist[v];
+        Acc same = 0, cross = 0;
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            Acc wk = w[k];
+            bool sameSide = ws.side[g.adjVertex[k]] == ws.side[v];
+            same += sameSide ? wk : 0;
+            cross += sameSide ? 0 : wk;
+        }
+        ws.gain[v] = (long long)same - cross;
+        cut += cross;
     }
+    ws.cutWeight = cut / 2;
+}
 
-    return {X, Y};
+// Toroidal grid kernels. Neighbours come from the cell index, so these read only the partition
+// and the per-cell weights, a row at a time, and their inner loops vectorise.
+// They need a complete partition; s is ws.side shifted to cell indices.
+
+// Gains of the cells of row r into out[0 .. cols)
+template <typename Acc, typename GridWeights>
+void gridRowGains(const GridLayout& grid, const signed char* s, int r, GridWeights w, long long* out) {
+    int cols = grid.cols;
+    int base = r * cols, up = (r + grid.rows - 1) % grid.rows * cols, down = (r + 1) % grid.rows * cols;
+    // +w towards a neighbour on the same side, -w across the cut
+    auto term = [](Acc wk, int a, int b) { return wk - 2 * wk * (a ^ b); };
+    auto cell = [&](int c, int left, int right) {
+        int i = base + c, x = s[i];
+        return (long long)(term(w.right(i), x, s[base + right]) + term(w.right(base + left), x, s[base + left]) +
+                           term(w.down(i), x, s[down + c]) + term(w.down(up + c), x, s[up + c]));
+    };
+    out[0] = cell(0, cols - 1, 1);
+    for (int c = 1; c < cols - 1; c++) out[c] = cell(c, c - 1, c + 1);
+    out[cols - 1] = cell(cols - 1, cols - 2, 0);
 }
 
-// Local Search Max-Cut
-pair<pair<unordered_set<int>, unordered_set<int>>, int> localSearchMaxCut(const Graph& g, unordered_set<int> X, unordered_set<int> Y) {
+// computeGains for a grid graph
+template <typename Acc, typename GridWeights>
+void computeGridGains(MaxCutWorkspace& ws, GridWeights w) {
+    const GridLayout& grid = ws.g.grid;
+    const signed char* s = ws.side.data() + 1;
+    int cols = grid.cols;
+    long long cut = 0;
+    for (int r = 0; r < grid.rows; r++) {
+        gridRowGains<Acc>(grid, s, r, w, ws.gain.data() + 1 + r * cols);
+        // Each cell owns its right and lower edge
+        int base = r * cols, down = (r + 1) % grid.rows * cols;
+        int last = base + cols - 1;
+        long long rowCut = (long long)w.right(last) * (s[last] ^ s[base]) + (long long)w.down(last) * (s[last] ^ s[down + cols - 1]);
+        for (int c = 0; c < cols - 1; c++) {
+            int i = base + c;
+            rowCut += (long long)w.right(i) * (s[i] ^ s[i + 1]) + (long long)w.down(i) * (s[i] ^ s[down + c]);
+        }
+        cut += rowCut;
+    }
+    ws.cutWeight = cut;
+    ws.hash = 0;
+    for (int v = 1; v <= ws.g.V; v++)
+        if (ws.side[v] == 1) ws.hash ^= ws.zobrist[v];
+}
+
+// Local search for a grid graph: the same first-improvement passes as localSearch, in the same
+// vertex order, but a flip finds its four neighbours by index arithmetic on the row and column
+template <typename Acc, typename GridWeights>
+int gridLocalSearch(MaxCutWorkspace& ws, GridWeights w) {
+    const GridLayout& grid = ws.g.grid;
+    signed char* s = ws.side.data() + 1;
+    long long* gain = ws.gain.data() + 1;
+    int rows = grid.rows, cols = grid.cols;
     bool improved = true;
     int iterations = 0;
-
     while (improved) {
         iterations++;
+        TraceScope trace("local search pass", iterations);
         improved = false;
+        for (int r = 0; r < rows; r++) {
+            int base = r * cols;
+            int up = (r + rows - 1) % rows * cols - base, down = (r + 1) % rows * cols - base;
+            for (int c = 0; c < cols; c++) {
+                int i = base + c;
+                if (gain[i] <= 0) continue;
+                int x = s[i];
+                int left = c > 0 ? i - 1 : i + cols - 1, right = c < cols - 1 ? i + 1 : base;
+                auto update = [&](int j, Acc wk) { gain[j] += s[j] == x ? -2 * wk : 2 * wk; };
+                update(left, w.right(left));
+                update(right, w.right(i));
+                update(i + up, w.down(i + up));
+                update(i + down, w.down(i));
+                ws.cutWeight += gain[i];
+                gain[i] = -gain[i];
+                s[i] ^= 1;
+                ws.hash ^= ws.zobrist[i + 1];
+                improved = true;
+            }
+        }
+    }
+    return iterations;
+}
 
-        // Try moving each vertex to the other unordered_set
-        for (int v = 1; v <= g.V; v++) {
-            if (X.count(v) == 0 && Y.count(v) == 0) continue;  // Skip if the vertex is not in either unordered_set
+// popcount(a & b) over n words, with AVX-512 or AVX2 paths when compiled for them
+inline int popcountAnd(const uint64_t* a, const uint64_t* b, int n) {
+    int i = 0;
+    long long count = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 8 <= n; i += 8)
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i))));
+    if (i < n) {
+        __mmask8 tail = (1u << (n - i)) - 1;
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_and_si512(_mm512_maskz_loadu_epi64(tail, a + i), _mm512_maskz_loadu_epi64(tail, b + i))));
+        i = n;
+    }
+    alignas(64) long long lanes[8];
+    _mm512_store_si512(lanes, acc);
+    for (long long lane : lanes) count += lane;
+#elif defined(__AVX2__)
+    // Nibble lookup table, summed per 64-bit lane with SAD
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+                                        _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+#endif
+    for (; i < n; i++) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+}
 
-            long long sigmaS = 0, sigmaSbar = 0;
-            for (const Edge& e : g.edges) {
-                if (e.u == v) {
-                    if (Y.count(e.v)) sigmaS += e.weight;  // Vertex `v` is connected to `Y`
-                    else sigmaSbar += e.weight;             // Vertex `v` is connected to `X`
-                }
-                else if (e.v == v) {
-                    if (Y.count(e.u)) sigmaS += e.weight;  // Vertex `v` is connected to `Y`
-                    else sigmaSbar += e.weight;             // Vertex `v` is connected to `X`
-                }
+// Dense kernels. With Y as a bitset, the neighbours of v with weight w on Y's side number
+// popcount(row & Y), so a gain is a few AND + popcount per distinct weight.
+
+void buildSideBits(MaxCutWorkspace& ws) {
+    fill(ws.sideBits.begin(), ws.sideBits.end(), 0);
+    for (int v = 1; v <= ws.g.V; v++)
+        if (ws.side[v] == 1) ws.sideBits[v / 64] |= 1ULL << (v % 64);
+}
+
+// computeGains for a dense graph
+void computeDenseGains(MaxCutWorkspace& ws) {
+    const Graph& g = ws.g;
+    const DenseLayout& d = g.dense;
+    buildSideBits(ws);
+    long long cut = 0;
+    ws.hash = 0;
+    for (int v = 1; v <= g.V; v++) {
+        if (ws.side[v] == 1) ws.hash ^= ws.zobrist[v];
+        long long gain = 0;
+        for (int c = 0; c < (int)d.weights.size(); c++) {
+            int degree = d.degree[c * (g.V + 1) + v];
+            if (degree == 0) continue;
+            int inY = popcountAnd(d.row(c, v, g.V), ws.sideBits.data(), d.words);
+            int same = ws.side[v] == 1 ? inY : degree - inY;
+            gain += (long long)d.weights[c] * (2 * same - degree);
+            cut += (long long)d.weights[c] * (degree - same);
+        }
+        ws.gain[v] = gain;
+    }
+    ws.cutWeight = cut / 2;
+}
+
+// flipVertex for a dense graph; neighbours come from the set bits of v's rows
+void denseFlipVertex(MaxCutWorkspace& ws, int v) {
+    const Graph& g = ws.g;
+    const DenseLayout& d = g.dense;
+    ws.cutWeight += ws.gain[v];
+    for (int c = 0; c < (int)d.weights.size(); c++) {
+        const uint64_t* row = d.row(c, v, g.V);
+        long long delta = 2LL * d.weights[c];
+        for (int k = 0; k < d.words; k++) {
+            for (uint64_t x = row[k]; x; x &= x - 1) {
+                int u = k * 64 + __builtin_ctzll(x);
+                ws.gain[u] += ws.side[u] == ws.side[v] ? -delta : delta;
             }
+        }
+    }
+    ws.side[v] ^= 1;
+    ws.sideBits[v / 64] ^= 1ULL << (v % 64);
+    ws.gain[v] = -ws.gain[v];
+    ws.hash ^= ws.zobrist[v];
+}
 
-            // Move vertex from X to Y if the condition holds
-            if (X.count(v) && (sigmaSbar - sigmaS > 0)) {
-                // Remove from X and add to Y
-                X.erase(v);
-                Y.insert(v);
+// localSearch for a dense graph, same order and result as the CSR one
+int denseLocalSearch(MaxCutWorkspace& ws) {
+    buildSideBits(ws);
+    bool improved = true;
+    int iterations = 0;
+    while (improved) {
+        iterations++;
+        TraceScope trace("local search pass", iterations);
+        improved = false;
+        for (int v = 1; v <= ws.g.V; v++) {
+            if (ws.gain[v] > 0) {
+                denseFlipVertex(ws, v);
                 improved = true;
             }
-            // Move vertex from Y to X if the condition holds
-            else if (Y.count(v) && (sigmaS - sigmaSbar > 0)) {
-                // Remove from Y and add to X
-                Y.erase(v);
-                X.insert(v);
+        }
+    }
+    return iterations;
+}
+
+// Grid and dense graphs take their own kernels once the partition is complete
+bool isComplete(const MaxCutWorkspace& ws) {
+    return find(ws.side.begin() + 1, ws.side.end(), -1) == ws.side.end();
+}
+
+bool useGridKernels(const MaxCutWorkspace& ws) {
+    return ws.g.isGrid() && isComplete(ws);
+}
+
+bool useDenseKernels(const MaxCutWorkspace& ws) {
+    return ws.g.isDense() && isComplete(ws);
+}
+
+void computeGains(MaxCutWorkspace& ws) {
+    TraceScope trace("cut evaluation");
+    if (useGridKernels(ws)) {
+        withGridKernelTypes(ws.g, [&](auto weights, auto acc) { computeGridGains<decltype(acc)>(ws, weights); });
+        return;
+    }
+    if (useDenseKernels(ws)) {
+        computeDenseGains(ws);
+        return;
+    }
+    withKernelTypes(ws.g, [&](auto weights, auto acc) { computeGains<decltype(acc)>(ws, weights); });
+}
+
+// Move v to the other side, keeping gains and the cut weight current
+template <typename Weights>
+void flipVertex(MaxCutWorkspace& ws, int v, Weights w) {
+    const Graph& g = ws.g;
+    ws.cutWeight += ws.gain[v];
+    for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+        int u = g.adjVertex[k];
+        long long delta = 2LL * w[k];
+        ws.gain[u] += ws.side[u] == ws.side[v] ? -delta : delta;
+    }
+    ws.side[v] ^= 1;
+    ws.gain[v] = -ws.gain[v];
+    ws.hash ^= ws.zobrist[v];
+}
+
+void flipVertex(MaxCutWorkspace& ws, int v) {
+    withWeights(ws.g, [&](auto weights) { flipVertex(ws, v, weights); });
+}
+
+template <typename Weights>
+void assignVertex(MaxCutWorkspace& ws, int v, int which, Weights w) {
+    const Graph& g = ws.g;
+    ws.side[v] = which;
+    if (which == 1) ws.hash ^= ws.zobrist[v];
+    vector<long long>& sigma = which == 0 ? ws.sigmaY : ws.sigmaX;
+    for (int k = g.offset[v]; k < g.offset[v + 1]; k++) sigma[g.adjVertex[k]] += w[k];
+    int idx = ws.position[v], last = ws.candidates.back();
+    ws.candidates[idx] = last;
+    ws.position[last] = idx;
+    ws.candidates.pop_back();
+    ws.position[v] = -1;
+}
+
+// Assign every vertex in ws.candidates by the semi-greedy rule. sigmaX / sigmaY of the
+// candidates must already hold their weight towards the assigned vertices.
+template <typename Weights>
+void semiGreedyComplete(MaxCutWorkspace& ws, double alpha, mt19937& rng, Weights w) {
+    while (!ws.candidates.empty()) {
+        // Range of greedy values over the unassigned vertices
+        long long w_min = LLONG_MAX, w_max = LLONG_MIN;
+        for (int v : ws.candidates) {
+            w_min = min(w_min, min(ws.sigmaX[v], ws.sigmaY[v]));
+            w_max = max(w_max, max(ws.sigmaX[v], ws.sigmaY[v]));
+        }
+
+        // Restricted Candidate List, falling back to every candidate if it is empty
+        double mu = w_min + alpha * (w_max - w_min);
+        ws.rcl.clear();
+        for (int i = 0; i < (int)ws.candidates.size(); i++) {
+            int v = ws.candidates[i];
+            if (max(ws.sigmaX[v], ws.sigmaY[v]) >= mu) ws.rcl.push_back(i);
+        }
+        int pick = ws.rcl.empty() ? rng() % ws.candidates.size() : ws.rcl[rng() % ws.rcl.size()];
+
+        // Put the chosen vertex in the set that maximizes the cut weight
+        int v = ws.candidates[pick];
+        assignVertex(ws, v, ws.sigmaX[v] > ws.sigmaY[v] ? 0 : 1, w);
+    }
+}
+
+// Semi-greedy construction into ws.side
+template <typename Weights>
+void semiGreedyConstruct(MaxCutWorkspace& ws, double alpha, mt19937& rng, Weights w) {
+    const Graph& g = ws.g;
+
+    // Step 1: Every vertex starts unassigned with no weight towards either set
+    ws.candidates.clear();
+    ws.hash = 0;
+    for (int v = 1; v <= g.V; v++) {
+        ws.side[v] = -1;
+        ws.sigmaX[v] = ws.sigmaY[v] = 0;
+        ws.position[v] = ws.candidates.size();
+        ws.candidates.push_back(v);
+    }
+
+    // Step 2: Start from the edge with the maximum weight
+    assignVertex(ws, ws.maxEdge.u, 0, w);
+    if (ws.side[ws.maxEdge.v] == -1) assignVertex(ws, ws.maxEdge.v, 1, w);
+
+    // Step 3: Continue until all vertices are assigned
+    semiGreedyComplete(ws, alpha, rng, w);
+}
+
+void semiGreedyConstruct(MaxCutWorkspace& ws, double alpha, mt19937& rng) {
+    TraceScope trace("construction");
+    withWeights(ws.g, [&](auto weights) { semiGreedyConstruct(ws, alpha, rng, weights); });
+    computeGains(ws);
+}
+
+// First-improvement local search on ws.side; returns the number of passes
+template <typename Weights>
+int localSearch(MaxCutWorkspace& ws, Weights w) {
+    bool improved = true;
+    int iterations = 0;
+    while (improved) {
+        iterations++;
+        TraceScope trace("local search pass", iterations);
+        improved = false;
+        for (int v = 1; v <= ws.g.V; v++) {
+            if (ws.side[v] != -1 && ws.gain[v] > 0) {
+                flipVertex(ws, v, w);
                 improved = true;
             }
         }
     }
+    return iterations;
+}
 
-    return {{X, Y}, iterations};
+int localSearch(MaxCutWorkspace& ws) {
+    int iterations = 0;
+    if (useGridKernels(ws)) {
+        withGridKernelTypes(ws.g, [&](auto weights, auto acc) { iterations = gridLocalSearch<decltype(acc)>(ws, weights); });
+        return iterations;
+    }
+    if (useDenseKernels(ws) && ws.g.density() >= Graph::denseSearchThreshold) return denseLocalSearch(ws);
+    withWeights(ws.g, [&](auto weights) { iterations = localSearch(ws, weights); });
+    return iterations;
 }
 
-// GRASP Max-Cut
-pair<unordered_set<int>, unordered_set<int>> GRASP(const Graph& g, int maxIterations, double alpha, int earlyStopThreshold = 10) {
-    unordered_set<int> bestX, bestY;
-    int bestWeight = -1;
+// Semi-Greedy Max-Cut
+// Takes its own generator so several threads can construct solutions at once
+pair<unordered_set<int>, unordered_set<int>> semiGreedyMaxCut(const Graph& g, double alpha, mt19937& rng) {
+    MaxCutWorkspace ws(g);
+    semiGreedyConstruct(ws, alpha, rng);
+    return {sideToSet(ws.side, 0), sideToSet(ws.side, 1)};
+}
+
+pair<unordered_set<int>, unordered_set<int>> semiGreedyMaxCut(const Graph& g, double alpha) {
+    mt19937 rng(rand());
+    return semiGreedyMaxCut(g, alpha, rng);
+}
+
+// Local Search Max-Cut
+pair<pair<unordered_set<int>, unordered_set<int>>, int> localSearchMaxCut(const Graph& g, const unordered_set<int>& X, const unordered_set<int>& Y) {
+    MaxCutWorkspace ws(g);
+    setsToSide(X, Y, ws.side);
+    computeGains(ws);
+    int iterations = localSearch(ws);
+    return {{sideToSet(ws.side, 0), sideToSet(ws.side, 1)}, iterations};
+}
+
+// GRASP's default onNewBest, which ignores new incumbents
+struct IgnoreNewBest {
+    void operator()(const MaxCutWorkspace&, int) const {}
+};
+
+struct GRASPStats {
+    int iterations = 0;      // iterations actually run
+    int duplicates = 0;      // iterations that reached an already visited partition
+    int skippedSearches = 0; // duplicates caught before local search, which was skipped
+    size_t peakBytes = 0;    // workspace memory, which holds everything GRASP allocates
+};
+
+// GRASP on a workspace; the best partition is left in ws.bestSide / ws.bestWeight.
+// If ws.side already holds a complete partition (seeded) it is improved and kept as the incumbent.
+// Once the workspace exists an iteration allocates nothing: construction and search reuse its
+// buffers and a new best is swapped in rather than copied.
+// Visited partitions are remembered by hash; a local optimum already seen cannot be a new best.
+// When improve is deterministic a construction already seen would reach a known optimum, so its
+// search is skipped. GRASP also stops once more than maxDuplicateRate of at least
+// minIterationsForRate iterations were duplicates, and before an iteration that would start
+// after deadline.
+// improve(ws) is the improvement phase; it must leave ws.gain and ws.cutWeight current.
+// onNewBest(ws, iteration) runs each time a new best is kept, iteration counting from 1 (0 for the seed).
+template <typename Improve, typename OnNewBest = IgnoreNewBest>
+GRASPStats GRASP(MaxCutWorkspace& ws, int maxIterations, double alpha, mt19937& rng, Improve improve, bool deterministicImprove,
+                 int earlyStopThreshold = 10, bool seeded = false, double maxDuplicateRate = 0.8, int minIterationsForRate = 10,
+                 chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max(), OnNewBest onNewBest = OnNewBest()) {
+    bool timed = deadline != chrono::steady_clock::time_point::max();
+    GRASPStats stats;
+    ws.bestWeight = -1;
+    ws.visited.reset(2 * (size_t)max(maxIterations, 0) + 2);
     int noImprovementCount = 0;
 
+    if (seeded) {
+        computeGains(ws);
+        ws.visited.insert(ws.partitionHash());
+        improve(ws);
+        ws.visited.insert(ws.partitionHash());
+        ws.keepAsBest();
+        onNewBest(ws, 0);
+    }
+
     for (int i = 0; i < maxIterations; ++i) {
-        auto [X, Y] = semiGreedyMaxCut(g, alpha);
+        if (timed && chrono::steady_clock::now() >= deadline) break;
+        TraceScope trace("grasp iteration", i);
+        stats.iterations++;
+        semiGreedyConstruct(ws, alpha, rng);
 
-        // Unpack the result from localSearchMaxCut
-        auto [partition, iter] = localSearchMaxCut(g, X, Y);
-        auto [newX, newY] = partition;
+        uint64_t constructed = ws.partitionHash();
+        bool seen = !ws.visited.insert(constructed);
+        bool duplicate = seen;
+        if (seen && deterministicImprove) {
+            stats.skippedSearches++;
+        } else {
+            improve(ws);
+            uint64_t optimum = ws.partitionHash();
+            duplicate = optimum == constructed ? seen : !ws.visited.insert(optimum);
+        }
 
-        int weight = computeCutWeight(g, newX, newY);
-        
         // Check if the solution has improved
-        if (weight > bestWeight) {
-            bestWeight = weight;
-            bestX = newX;
-            bestY = newY;
+        if (!duplicate && ws.cutWeight > ws.bestWeight) {
+            ws.keepAsBest();
+            onNewBest(ws, stats.iterations);
             noImprovementCount = 0;  // Reset if we found a better solution
         } else {
             noImprovementCount++;
         }
+        if (duplicate) stats.duplicates++;
 
         // Early stopping condition: If no improvement over a certain number of iterations, stop
         if (noImprovementCount >= earlyStopThreshold) {
             break;
         }
+        // Or if construction keeps landing on optima we already have
+        if (stats.iterations >= minIterationsForRate && stats.duplicates > maxDuplicateRate * stats.iterations) {
+            break;
+        }
     }
+    stats.peakBytes = ws.bytes();
+    return stats;
+}
 
-    return {bestX, bestY};
+// GRASP with first-improvement local search
+GRASPStats GRASP(MaxCutWorkspace& ws, int maxIterations, double alpha, mt19937& rng, int earlyStopThreshold = 10, bool seeded = false,
+                 double maxDuplicateRate = 0.8, int minIterationsForRate = 10) {
+    return GRASP(ws, maxIterations, alpha, rng, [](MaxCutWorkspace& w) { localSearch(w); }, true, earlyStopThreshold, seeded,
+                 maxDuplicateRate, minIterationsForRate);
+}
+
+// GRASP Max-Cut
+// If seed is given it is locally improved and used as the starting incumbent
+pair<unordered_set<int>, unordered_set<int>> GRASP(const Graph& g, int maxIterations, double alpha, int earlyStopThreshold = 10,
+                                                   const pair<unordered_set<int>, unordered_set<int>>* seed = nullptr,
+                                                   GRASPStats* stats = nullptr) {
+    MaxCutWorkspace ws(g);
+    mt19937 rng(rand());
+    if (seed) setsToSide(seed->first, seed->second, ws.side);
+    GRASPStats run = GRASP(ws, maxIterations, alpha, rng, earlyStopThreshold, seed != nullptr);
+    if (stats) *stats = run;
+    return {sideToSet(ws.bestSide, 0), sideToSet(ws.bestSide, 1)};
 }
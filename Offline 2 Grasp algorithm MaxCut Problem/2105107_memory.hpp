@@ -0,0 +1,35 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <sstream>
+#include <sys/resource.h>
+
+// Process memory for the benchmark drivers: peak resident set size, and solver footprints
+// scaled per vertex and per edge so graphs of different sizes compare.
+
+// Peak resident set size in bytes since the start or the last resetPeakRSS()
+size_t peakRSSBytes() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return stoull(line.substr(6)) * 1024;
+    }
+    // No procfs: getrusage reports kilobytes on Linux, and cannot be reset
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (size_t)usage.ru_maxrss * 1024;
+}
+
+// Start a new peak from the current RSS (Linux 4.0+); false where that is not supported
+bool resetPeakRSS() {
+    ofstream clear("/proc/self/clear_refs");
+    clear << "5" << flush;
+    return (bool)clear;
+}
+
+// "123456 bytes (12.3 B/vertex, 4.56 B/edge)"
+string footprint(size_t bytes, const Graph& g) {
+    ostringstream text;
+    text.precision(3);
+    text << bytes << " bytes (" << (double)bytes / max(1, g.V) << " B/vertex, " << (double)bytes / max<size_t>(1, g.edgeCount()) << " B/edge)";
+    return text.str();
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+
+// Proper vertex colouring; vertices in one class share no edge
+struct GraphColoring {
+    vector<int> color;            // color[v] for v = 1..V
+    vector<vector<int>> classes;  // vertices of each colour
+};
+
+// Greedy colouring in decreasing degree order (Welsh-Powell), computed once per graph
+GraphColoring greedyColoring(const Graph& g) {
+    GraphColoring coloring;
+    coloring.color.assign(g.V + 1, -1);
+
+    vector<int> order(g.V);
+    for (int v = 1; v <= g.V; v++) order[v - 1] = v;
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return g.offset[a + 1] - g.offset[a] > g.offset[b + 1] - g.offset[b];
+    });
+
+    // usedBy[c] == v marks colour c as taken by a neighbour of v
+    vector<int> usedBy(g.V + 1, 0);
+    for (int v : order) {
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int c = coloring.color[g.adjVertex[k]];
+            if (c >= 0) usedBy[c] = v;
+        }
+        int c = 0;
+        while (usedBy[c] == v) c++;
+        coloring.color[v] = c;
+        if (c == (int)coloring.classes.size()) coloring.classes.emplace_back();
+        coloring.classes[c].push_back(v);
+    }
+    return coloring;
+}
+
+// Local search that flips every improving vertex of one colour class at once.
+// No two of them are adjacent, so their gains are independent and the cut grows by their sum.
+// A shared neighbour can still receive updates from several threads, hence the atomic gain update.
+// Repeats over all classes until none improves; returns the number of rounds.
+template <typename Weights>
+int parallelLocalSearch(MaxCutWorkspace& ws, const GraphColoring& coloring, Weights w) {
+    const Graph& g = ws.g;
+    bool improved = true;
+    int iterations = 0;
+    while (improved) {
+        iterations++;
+        improved = false;
+        for (const vector<int>& members : coloring.classes) {
+            long long cutDelta = 0;
+            int flips = 0;
+            uint64_t hashDelta = 0;
+            #pragma omp parallel for schedule(dynamic, 64) reduction(+:cutDelta, flips) reduction(^:hashDelta)
+            for (size_t i = 0; i < members.size(); i++) {
+                int v = members[i];
+                long long gv = ws.gain[v];
+                if (ws.side[v] == -1 || gv <= 0) continue;
+                for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+                    int u = g.adjVertex[k];
+                    long long delta = ws.side[u] == ws.side[v] ? -2LL * w[k] : 2LL * w[k];
+                    #pragma omp atomic
+                    ws.gain[u] += delta;
+                }
+                cutDelta += gv;
+                ws.side[v] ^= 1;
+                ws.gain[v] = -gv;
+                hashDelta ^= ws.zobrist[v];
+                flips++;
+            }
+            ws.cutWeight += cutDelta;
+            ws.hash ^= hashDelta;
+            if (flips > 0) improved = true;
+        }
+    }
+    return iterations;
+}
+
+int parallelLocalSearch(MaxCutWorkspace& ws, const GraphColoring& coloring) {
+    int iterations = 0;
+    withWeights(ws.g, [&](auto weights) { iterations = parallelLocalSearch(ws, coloring, weights); });
+    return iterations;
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Bounded multi-producer multi-consumer queue (Vyukov ring buffer).
+// Each slot carries a sequence number telling producers and consumers whose turn it is,
+// so push and pop only ever CAS a head or tail index and never take a lock.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        slots = vector<Slot>(size);
+        for (size_t i = 0; i < size; i++) slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    // Returns false when the queue is full
+    bool tryPush(T& item) {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(memory_order_acquire);
+            long long diff = (long long)seq - (long long)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false when the queue is empty
+    bool tryPop(T& item) {
+        size_t pos = head.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(memory_order_acquire);
+            long long diff = (long long)seq - (long long)(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    item = std::move(slot.value);
+                    slot.sequence.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        atomic<size_t> sequence{0};
+        T value;
+    };
+    vector<Slot> slots;
+    size_t mask = 0;
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<size_t> tail{0};
+};
+
+struct PipelineConfig {
+    int producers = 1;      // threads running semi-greedy construction
+    int consumers = 1;      // threads running local search
+    int queueCapacity = 8;  // constructions allowed to wait for local search
+};
+
+// Per-stage timings so the producer/consumer split can be tuned per graph family
+struct PipelineStats {
+    double constructionSeconds = 0;  // summed over producers
+    double localSearchSeconds = 0;   // summed over consumers
+    long long producerStalls = 0;    // pushes refused because the queue was full
+    long long consumerStalls = 0;    // pops refused because the queue was empty
+};
+
+// Pipelined GRASP Max-Cut
+// Producers build semi-greedy solutions into a bounded queue, consumers pull them,
+// run local search and publish into a shared best. A full queue makes producers wait
+// (back-pressure), so constructions never run far ahead of the slower stage.
+// There is no early stop: completion order across threads says nothing about progress.
+// Every thread works in its own MaxCutWorkspace and partitions travel as side arrays drawn from
+// a fixed pool, which consumers hand back after swapping them into their workspace, so the
+// pipeline allocates nothing once its threads are running.
+pair<unordered_set<int>, unordered_set<int>> pipelinedGRASP(const Graph& g, int maxIterations, double alpha,
+                                                            PipelineConfig config = {}, PipelineStats* stats = nullptr) {
+    using Side = vector<signed char>;
+    int producers = max(1, config.producers), consumers = max(1, config.consumers);
+    int capacity = max(1, config.queueCapacity);
+    BoundedQueue<Side> queue(capacity);
+    // Queued, under construction, or free: capacity + producers buffers cover them all
+    BoundedQueue<Side> freeSides(capacity + producers);
+    for (int i = 0; i < capacity + producers; i++) {
+        Side side(g.V + 1, -1);
+        freeSides.tryPush(side);
+    }
+
+    atomic<int> nextConstruction{0};
+    atomic<int> finishedSearches{0};
+    atomic<long long> bestWeight{-1};
+    mutex bestMutex;
+    Side best(g.V + 1, -1);
+    long long bestStored = -1;
+
+    atomic<long long> constructionNanos{0}, searchNanos{0}, producerStalls{0}, consumerStalls{0};
+    unsigned baseSeed = rand();
+
+    auto producer = [&](int id) {
+        mt19937 rng(baseSeed + 7919u * id);
+        MaxCutWorkspace ws(g);
+        Side solution;
+        while (nextConstruction.fetch_add(1) < maxIterations) {
+            auto start = chrono::steady_clock::now();
+            semiGreedyConstruct(ws, alpha, rng);
+            constructionNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            while (!freeSides.tryPop(solution)) {
+                producerStalls++;
+                this_thread::yield();
+            }
+            solution = ws.side;  // same size, so no allocation
+            if (!queue.tryPush(solution)) {
+                TraceScope trace("queue full");
+                do {
+                    producerStalls++;
+                    this_thread::yield();
+                } while (!queue.tryPush(solution));
+            }
+        }
+    };
+
+    auto consumer = [&]() {
+        MaxCutWorkspace ws(g);
+        Side solution;
+        Tracer& tracer = Tracer::instance();
+        uint64_t waitStart = 0;  // one "queue empty" event per wait, not per refused pop
+        while (finishedSearches.load() < maxIterations) {
+            if (!queue.tryPop(solution)) {
+                if (!waitStart && tracer.enabled()) waitStart = tracer.now();
+                consumerStalls++;
+                this_thread::yield();
+                continue;
+            }
+            if (waitStart) {
+                tracer.record("queue empty", 0, waitStart, tracer.now());
+                waitStart = 0;
+            }
+            TraceScope trace("local search");
+            auto start = chrono::steady_clock::now();
+            swap(ws.side, solution);
+            freeSides.tryPush(solution);  // the pool has room for every buffer
+            computeGains(ws);
+            localSearch(ws);
+            long long weight = ws.cutWeight;
+            searchNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+            // Cheap atomic filter first, the lock is only taken by a consumer that raised the best
+            long long seen = bestWeight.load();
+            while (weight > seen && !bestWeight.compare_exchange_weak(seen, weight)) {}
+            if (weight > seen) {
+                lock_guard<mutex> lock(bestMutex);
+                if (weight > bestStored) {
+                    bestStored = weight;
+                    best = ws.side;
+                }
+            }
+            finishedSearches++;
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 0; i < producers; i++) threads.emplace_back(producer, i);
+    for (int i = 0; i < consumers; i++) threads.emplace_back(consumer);
+    for (thread& t : threads) t.join();
+
+    if (stats) {
+        stats->constructionSeconds = constructionNanos.load() / 1e9;
+        stats->localSearchSeconds = searchNanos.load() / 1e9;
+        stats->producerStalls = producerStalls.load();
+        stats->consumerStalls = consumerStalls.load();
+    }
+    return {sideToSet(best, 0), sideToSet(best, 1)};
+}
@@ -0,0 +1,208 @@
+#include "2105107_maxcut.hpp"
+#include "2105107_spectral.hpp"
+#include "2105107_pipeline.hpp"
+#include "2105107_lns.hpp"
+#include "2105107_vns.hpp"
+#include "2105107_known_best.hpp"
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
+// Quality-and-latency regression gate for the solvers.
+// Each baseline row names a G-set graph, a solver, the largest gap to the known best allowed for
+// the median cut over the fixed seeds, and the largest median wall time allowed. Any row over
+// either limit is listed in a diff report and the exit status is 1.
+
+const vector<unsigned> regressionSeeds = {1, 2, 3, 4, 5};
+const int graspIterations = 50;
+const double graspAlpha = 0.75;
+
+// Cut weight found on g by one seeded run
+using Solver = function<long long(const Graph&, unsigned)>;
+
+const map<string, Solver>& solvers() {
+    static const map<string, Solver> table = {
+        {"local", [](const Graph& g, unsigned seed) {
+             MaxCutWorkspace ws(g);
+             mt19937 rng(seed);
+             semiGreedyConstruct(ws, graspAlpha, rng);
+             localSearch(ws);
+             return ws.cutWeight;
+         }},
+        {"grasp", [](const Graph& g, unsigned seed) {
+             MaxCutWorkspace ws(g);
+             mt19937 rng(seed);
+             GRASP(ws, graspIterations, graspAlpha, rng);
+             return ws.bestWeight;
+         }},
+        {"grasp-vns", [](const Graph& g, unsigned seed) {
+             MaxCutWorkspace ws(g);
+             mt19937 rng(seed);
+             vnsGRASP(ws, graspIterations, graspAlpha, rng);
+             return ws.bestWeight;
+         }},
+        {"lns", [](const Graph& g, unsigned seed) {
+             MaxCutWorkspace ws(g);
+             mt19937 rng(seed);
+             LNSConfig config;
+             config.seconds = 0.2;
+             largeNeighbourhoodSearch(ws, config, rng);
+             return ws.bestWeight;
+         }},
+        {"spectral", [](const Graph& g, unsigned seed) {
+             srand(seed);
+             mt19937 rng(rand());  // as drawn before the rng became a parameter, so the baselines still apply
+             SpectralResult spectral = spectralMaxCut(g, rng);
+             auto [partition, iterations] = localSearchMaxCut(g, spectral.X, spectral.Y);
+             return (long long)computeCutWeight(g, partition.first, partition.second);
+         }},
+        {"pipeline", [](const Graph& g, unsigned seed) {
+             srand(seed);
+             auto [X, Y] = pipelinedGRASP(g, graspIterations, graspAlpha);
+             return (long long)computeCutWeight(g, X, Y);
+         }},
+    };
+    return table;
+}
+
+struct BaselineRow {
+    int graphNum;
+    string solver;
+    long long maxGap;
+    double maxSeconds;  // median wall time budget
+};
+
+struct Measurement {
+    long long cut = 0, gap = 0;  // median cut over the seeds and its gap to the known best
+    double seconds = 0;          // median wall time
+};
+
+template <typename T>
+T median(vector<T> values) {
+    nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+// Rows of "G<n>,solver,max_gap,max_median_seconds"; blank lines and # comments are skipped
+bool readBaseline(const string& path, vector<BaselineRow>& rows) {
+    ifstream file(path);
+    if (!file) return false;
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line.compare(0, 5, "graph") == 0) continue;
+        stringstream ss(line);
+        string graph, solver, gap, seconds;
+        getline(ss, graph, ',');
+        getline(ss, solver, ',');
+        getline(ss, gap, ',');
+        getline(ss, seconds, ',');
+        if (graph.size() < 2 || graph[0] != 'G' || !solvers().count(solver)) {
+            cerr << "Bad baseline row: " << line << endl;
+            return false;
+        }
+        rows.push_back({stoi(graph.substr(1)), solver, stoll(gap), stod(seconds)});
+    }
+    return true;
+}
+
+Measurement measure(const Graph& g, int graphNum, const Solver& solver) {
+    vector<long long> cuts;
+    vector<double> times;
+    for (unsigned seed : regressionSeeds) {
+        auto start = chrono::steady_clock::now();
+        cuts.push_back(solver(g, seed));
+        times.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    Measurement m;
+    m.cut = median(cuts);
+    m.gap = giveKnownbest(graphNum) - m.cut;
+    m.seconds = median(times);
+    return m;
+}
+
+// Usage: regression [baseline.csv] [update [time-slack] [gap-slack]]
+// update rewrites the baseline from this run: as gap limits the measured gaps plus gap-slack
+// (default 0.002) times the known best, which leaves room for the time-bounded LNS, and as time
+// budgets the measured median times times time-slack (default 3), at least 0.05 s
+int main(int argc, char* argv[]) {
+    TraceSession trace;  // MAXCUT_TRACE=<file.json> records a timeline of the run
+    string baselinePath = argc > 1 ? argv[1] : "2105107_regression.csv";
+    bool update = argc > 2 && string(argv[2]) == "update";
+    double timeSlack = argc > 3 ? atof(argv[3]) : 3.0;
+    double gapSlack = argc > 4 ? atof(argv[4]) : 0.002;
+
+    vector<BaselineRow> rows;
+    if (!readBaseline(baselinePath, rows) || rows.empty()) {
+        cerr << "No baseline rows in " << baselinePath << endl;
+        return 2;
+    }
+
+    // Step 1: Measure every row, loading each graph once
+    map<int, unique_ptr<Graph>> graphs;
+    vector<Measurement> results;
+    cout << fixed << setprecision(3);
+    cout << left << setw(6) << "graph" << setw(11) << "solver" << right << setw(8) << "cut" << setw(8) << "known" << setw(7) << "gap"
+         << setw(8) << "max" << setw(10) << "seconds" << setw(10) << "budget" << "  status" << endl;
+    for (const BaselineRow& row : rows) {
+        if (giveKnownbest(row.graphNum) < 0) {
+            cerr << "G" << row.graphNum << " has no known best value" << endl;
+            return 2;
+        }
+        auto& g = graphs[row.graphNum];
+        if (!g) {
+            try {
+                g = make_unique<Graph>(readGraphFromFile("graph_GRASP/set1/g" + to_string(row.graphNum) + ".rud"));
+            } catch (const runtime_error& e) {
+                cerr << e.what() << endl;
+                return 2;
+            }
+        }
+        Measurement m = measure(*g, row.graphNum, solvers().at(row.solver));
+        results.push_back(m);
+        bool pass = m.gap <= row.maxGap && m.seconds <= row.maxSeconds;
+        cout << left << setw(6) << ("G" + to_string(row.graphNum)) << setw(11) << row.solver << right << setw(8) << m.cut << setw(8)
+             << giveKnownbest(row.graphNum) << setw(7) << m.gap << setw(8) << row.maxGap << setw(10) << m.seconds << setw(10)
+             << row.maxSeconds << "  " << (update ? "measured" : pass ? "ok" : "FAIL") << endl;
+    }
+
+    // Step 2: Either write the new baseline ...
+    if (update) {
+        ofstream out(baselinePath);
+        out << "graph,solver,max_gap,max_median_seconds\n";
+        for (size_t i = 0; i < rows.size(); i++) {
+            long long gapLimit = results[i].gap + (long long)ceil(gapSlack * giveKnownbest(rows[i].graphNum));
+            out << "G" << rows[i].graphNum << "," << rows[i].solver << "," << gapLimit << "," << setprecision(2)
+                << max(0.05, results[i].seconds * timeSlack) << "\n";
+        }
+        cout << "Baseline written to " << baselinePath << endl;
+        return 0;
+    }
+
+    // ... or report what moved past its limit
+    ostringstream diff;
+    diff << fixed << setprecision(3);
+    int failures = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const BaselineRow& row = rows[i];
+        const Measurement& m = results[i];
+        string name = "G" + to_string(row.graphNum) + " " + row.solver;
+        if (m.gap > row.maxGap) {
+            failures++;
+            diff << "- " << name << ": gap " << row.maxGap << " -> " << m.gap << " (+" << m.gap - row.maxGap << ", median cut "
+                 << m.cut << ")\n";
+        }
+        if (m.seconds > row.maxSeconds) {
+            failures++;
+            diff << "- " << name << ": median seconds " << row.maxSeconds << " -> " << m.seconds << " (x"
+                 << setprecision(1) << m.seconds / row.maxSeconds << setprecision(3) << ")\n";
+        }
+    }
+    if (failures > 0) {
+        cout << "\nRegression: " << failures << " limit(s) exceeded against " << baselinePath << "\n" << diff.str();
+        return 1;
+    }
+    cout << "\nAll " << rows.size() << " rows within their limits" << endl;
+    return 0;
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+#include <cmath>
+
+// Spectral Max-Cut
+// For x in {-1, +1}^n the cut weight is x^T L x / 4 with L = D - W the weighted
+// Laplacian, so the top eigenvector of L is the relaxed optimum and
+// n/4 * lambda_max(L) bounds every cut from above.
+// Lanczos only shows that some eigenvalue lies within the residual of its Ritz value, not that
+// the top one does, so n/4 * lambdaMax is reported as an estimate. The only bound reported is the
+// total positive weight, capped by n/4 times the Gershgorin limit on lambda_max(L); that cap is
+// loose enough that on sparse graphs such as the G-set the bound is just the positive weight.
+struct SpectralResult {
+    unordered_set<int> X, Y;
+    double lambdaMax = 0;   // largest Ritz value of L
+    double residual = 0;    // ||L x - lambda x|| of the returned eigenvector
+    double estimate = 0;    // n/4 * lambdaMax, the relaxation's value if Lanczos found the top of the spectrum
+    double positiveWeightBound = 0;  // total positive weight, capped by n/4 * max row of |L| (Gershgorin)
+    int iterations = 0;     // Lanczos steps over all restarts
+    size_t peakBytes = 0;   // Lanczos vectors and basis, not counting X and Y
+};
+
+// y = L x over the CSR adjacency, rows split across threads
+template <typename Weights>
+void laplacianMultiply(const Graph& g, const vector<double>& degree, const vector<double>& x, vector<double>& y, Weights w) {
+    #pragma omp parallel for schedule(static)
+    for (int v = 1; v <= g.V; v++) {
+        double sum = degree[v] * x[v];
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++)
+            sum -= w[k] * x[g.adjVertex[k]];
+        y[v] = sum;
+    }
+}
+
+void laplacianMultiply(const Graph& g, const vector<double>& degree, const vector<double>& x, vector<double>& y) {
+    withWeights(g, [&](auto weights) { laplacianMultiply(g, degree, x, y, weights); });
+}
+
+double dotProduct(const vector<double>& a, const vector<double>& b) {
+    double sum = 0;
+    #pragma omp parallel for reduction(+:sum) schedule(static)
+    for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+}
+
+// Largest eigenpair of the symmetric tridiagonal matrix (diag, off) by implicit QL.
+// off[i] couples rows i and i + 1. Returns the eigenvalue, the eigenvector goes to vec.
+double tridiagonalTopEigen(vector<double> diag, vector<double> off, vector<double>& vec) {
+    int m = diag.size();
+    vector<vector<double>> z(m, vector<double>(m, 0.0));
+    for (int i = 0; i < m; i++) z[i][i] = 1.0;
+    off.resize(m, 0.0);
+
+    for (int l = 0; l < m; l++) {
+        int iter = 0, k;
+        do {
+            for (k = l; k < m - 1; k++) {
+                double dd = abs(diag[k]) + abs(diag[k + 1]);
+                if (abs(off[k]) <= 1e-15 * dd) break;
+            }
+            if (k == l) break;
+            if (++iter > 60) break;
+            double gg = (diag[l + 1] - diag[l]) / (2.0 * off[l]);
+            double r = hypot(gg, 1.0);
+            gg = diag[k] - diag[l] + off[l] / (gg + (gg >= 0 ? r : -r));
+            double s = 1.0, c = 1.0, p = 0.0;
+            int i;
+            for (i = k - 1; i >= l; i--) {
+                double f = s * off[i], b = c * off[i];
+                r = hypot(f, gg);
+                off[i + 1] = r;
+                if (r == 0.0) {
+                    diag[i + 1] -= p;
+                    off[k] = 0.0;
+                    break;
+                }
+                s = f / r;
+                c = gg / r;
+                gg = diag[i + 1] - p;
+                r = (diag[i] - gg) * s + 2.0 * c * b;
+                p = s * r;
+                diag[i + 1] = gg + p;
+                gg = c * r - b;
+                for (int row = 0; row < m; row++) {
+                    f = z[row][i + 1];
+                    z[row][i + 1] = s * z[row][i] + c * f;
+                    z[row][i] = c * z[row][i] - s * f;
+                }
+            }
+            if (r == 0.0 && i >= l) continue;
+            diag[l] -= p;
+            off[l] = gg;
+            off[k] = 0.0;
+        } while (k != l);
+    }
+
+    int top = max_element(diag.begin(), diag.end()) - diag.begin();
+    vec.resize(m);
+    for (int row = 0; row < m; row++) vec[row] = z[row][top];
+    return diag[top];
+}
+
+// Restarted Lanczos with full reorthogonalisation for the top eigenpair of L, then sign rounding.
+// The graph must meet MaxCutWorkspace's preconditions; the start vector is drawn from rng.
+SpectralResult spectralMaxCut(const Graph& g, mt19937& rng, int lanczosSteps = 60, int maxRestarts = 30, double tolerance = 1e-6) {
+    MaxCutWorkspace::solvable(g);
+    SpectralResult result;
+    int n = g.V;
+    int steps = max(1, min(lanczosSteps, n));
+
+    // Step 1: Weighted degrees
+    vector<double> degree(n + 1, 0.0);
+    forEachEdge(g, [&](int u, int v, int weight) {
+        degree[u] += weight;
+        degree[v] += weight;
+    });
+
+    // Step 2: Random start vector so it is not orthogonal to the top eigenvector
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    vector<double> x(n + 1, 0.0), w(n + 1, 0.0);
+    for (int v = 1; v <= n; v++) x[v] = dist(rng);
+
+    vector<vector<double>> Q(steps, vector<double>(n + 1, 0.0));
+    double lambda = 0, residual = 0;
+    for (int restart = 0; restart <= maxRestarts; restart++) {
+        double norm = sqrt(dotProduct(x, x));
+        for (int v = 1; v <= n; v++) Q[0][v] = x[v] / norm;
+
+        // Step 3: Build the Krylov basis and the tridiagonal projection
+        vector<double> alphas, betas;
+        for (int j = 0; j < steps; j++) {
+            laplacianMultiply(g, degree, Q[j], w);
+            result.iterations++;
+            alphas.push_back(dotProduct(Q[j], w));
+            // Two Gram-Schmidt passes; one pass lets the rounding error grow by alpha/beta per step
+            for (int pass = 0; pass < 2; pass++) {
+                for (int i = 0; i <= j; i++) {
+                    double h = dotProduct(Q[i], w);
+                    #pragma omp parallel for schedule(static)
+                    for (int v = 1; v <= n; v++) w[v] -= h * Q[i][v];
+                }
+            }
+            double beta = sqrt(dotProduct(w, w));
+            betas.push_back(beta);
+            if (j + 1 == steps || beta < 1e-12) break;
+            for (int v = 1; v <= n; v++) Q[j + 1][v] = w[v] / beta;
+        }
+
+        // Step 4: Ritz pair; the residual of Q s is |beta_last * s_last|
+        vector<double> s;
+        vector<double> off(betas.begin(), betas.end() - 1);
+        lambda = tridiagonalTopEigen(alphas, off, s);
+        residual = abs(betas.back() * s.back());
+
+        fill(x.begin(), x.end(), 0.0);
+        for (size_t i = 0; i < s.size(); i++)
+            for (int v = 1; v <= n; v++) x[v] += s[i] * Q[i][v];
+
+        if (residual <= tolerance * max(1.0, abs(lambda))) break;
+    }
+
+    // Step 5: Bound; every eigenvalue of L lies in a Gershgorin disc, and no cut exceeds the positive weight
+    long long positiveWeight = 0;
+    forEachEdge(g, [&](int, int, int weight) { if (weight > 0) positiveWeight += weight; });
+    double gershgorin = 0;
+    withWeights(g, [&](auto weights) {
+        for (int v = 1; v <= n; v++) {
+            double diagonal = degree[v], radius = 0;
+            for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+                if (g.adjVertex[k] == v) diagonal -= weights[k];
+                else radius += abs((double)weights[k]);
+            }
+            gershgorin = max(gershgorin, diagonal + radius);
+        }
+    });
+    result.lambdaMax = lambda;
+    result.residual = residual;
+    result.estimate = n / 4.0 * lambda;
+    result.positiveWeightBound = min(n / 4.0 * gershgorin, static_cast<double>(positiveWeight));
+    result.peakBytes = vectorBytes(degree) + vectorBytes(x) + vectorBytes(w) + Q.size() * vectorBytes(Q[0]) + (size_t)steps * steps * sizeof(double);
+
+    // Step 6: Round the eigenvector by sign
+    for (int v = 1; v <= n; v++) {
+        if (x[v] >= 0) result.X.insert(v);
+        else result.Y.insert(v);
+    }
+    return result;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads pulling tasks from one FIFO queue
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) {
+        for (int i = 0; i < max(1, threads); i++) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    function<void()> task;
+                    {
+                        unique_lock<mutex> lock(queueMutex);
+                        ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                        running++;
+                    }
+                    task();
+                    {
+                        lock_guard<mutex> lock(queueMutex);
+                        running--;
+                    }
+                    idle.notify_all();
+                }
+            });
+        }
+    }
+
+    // Finishes the queued tasks before the workers exit
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (thread& t : workers) t.join();
+    }
+
+    void submit(function<void()> task) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            tasks.push(std::move(task));
+        }
+        ready.notify_one();
+    }
+
+    // Block until the queue is empty and no task is running
+    void wait() {
+        unique_lock<mutex> lock(queueMutex);
+        idle.wait(lock, [this]() { return tasks.empty() && running == 0; });
+    }
+
+    int size() const { return workers.size(); }
+
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex queueMutex;
+    condition_variable ready, idle;
+    int running = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,149 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Timeline tracer writing Chrome trace JSON, viewable in ui.perfetto.dev or chrome://tracing.
+// Off until enable() is called, and a disabled TraceScope costs one relaxed load.
+// Every thread records into its own fixed-size ring buffer that keeps the newest events, so
+// recording takes no lock and allocates nothing after the thread's first event.
+
+struct TraceEvent {
+    const char* name;          // must outlive the tracer, e.g. a string literal
+    long long arg;             // shown as args.value, e.g. an iteration or graph number
+    uint64_t start, duration;  // nanoseconds since enable()
+};
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // Start recording, keeping up to eventsPerThread events per thread
+    void enable(size_t eventsPerThread = 1 << 16) {
+        capacity = max<size_t>(1, eventsPerThread);
+        epoch = chrono::steady_clock::now();
+        on.store(true, memory_order_relaxed);
+    }
+
+    void disable() { on.store(false, memory_order_relaxed); }
+    bool enabled() const { return on.load(memory_order_relaxed); }
+
+    // Nanoseconds since enable(), never 0 so 0 can mean "not recording"
+    uint64_t now() const {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count() + 1;
+    }
+
+    void record(const char* name, long long arg, uint64_t start, uint64_t end) {
+        ThreadBuffer& buffer = threadBuffer();
+        buffer.events[buffer.next % buffer.events.size()] = {name, arg, start, end - start};
+        buffer.next++;
+    }
+
+    // Write every thread's events as complete ("X") events. Call once the traced work has
+    // finished; threads still recording would race with the dump.
+    bool dump(const string& path) {
+        ofstream out(path);
+        if (!out) return false;
+        out << fixed << setprecision(3);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        lock_guard<mutex> lock(registryMutex);
+        for (const auto& buffer : buffers) {
+            out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+            first = false;
+            size_t size = buffer->events.size();
+            size_t begin = buffer->next > size ? buffer->next - size : 0;
+            for (size_t i = begin; i < buffer->next; i++) {
+                const TraceEvent& e = buffer->events[i % size];
+                out << ",\n{\"ph\":\"X\",\"name\":\"" << e.name << "\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << e.start / 1e3
+                    << ",\"dur\":" << e.duration / 1e3 << ",\"args\":{\"value\":" << e.arg << "}}";
+            }
+            if (begin > 0) {
+                out << ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << begin << " older events dropped\",\"pid\":1,\"tid\":" << buffer->tid
+                    << ",\"ts\":" << buffer->events[begin % size].start / 1e3 << "}";
+            }
+        }
+        out << "\n]}\n";
+        return true;
+    }
+
+private:
+    struct ThreadBuffer {
+        vector<TraceEvent> events;
+        size_t next = 0;  // events ever recorded; the newest events.size() of them are kept
+        int tid;
+    };
+
+    atomic<bool> on{false};
+    size_t capacity = 1 << 16;
+    chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+    mutex registryMutex;
+    vector<unique_ptr<ThreadBuffer>> buffers;  // kept after their thread exits, until the dump
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            lock_guard<mutex> lock(registryMutex);
+            buffers.push_back(make_unique<ThreadBuffer>());
+            buffer = buffers.back().get();
+            buffer->events.resize(capacity);
+            buffer->tid = buffers.size();
+        }
+        return *buffer;
+    }
+};
+
+// Records the enclosing block as one event when the tracer is on
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, long long arg = 0)
+        : name(name), arg(arg), start(Tracer::instance().enabled() ? Tracer::instance().now() : 0) {}
+
+    ~TraceScope() {
+        if (start) Tracer::instance().record(name, arg, start, Tracer::instance().now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    long long arg;
+    uint64_t start;
+};
+
+// Traces a driver run when the MAXCUT_TRACE environment variable names an output file.
+// Declare one at the top of main; the trace is written when it goes out of scope.
+class TraceSession {
+public:
+    TraceSession() {
+        const char* env = getenv("MAXCUT_TRACE");
+        if (!env || !*env) return;
+        path = env;
+        Tracer::instance().enable();
+    }
+
+    ~TraceSession() {
+        if (path.empty()) return;
+        Tracer::instance().disable();
+        if (Tracer::instance().dump(path)) cerr << "Trace written to " << path << endl;
+        else cerr << "Could not write trace to " << path << endl;
+    }
+
+private:
+    string path;
+};
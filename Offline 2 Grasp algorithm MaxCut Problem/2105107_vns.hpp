@@ -0,0 +1,201 @@
+#pragma once
+#include "2105107_maxcut.hpp"
+
+// Variable neighbourhood search for Max-Cut.
+// The descent goes back to the first neighbourhood after every improving move:
+//   N1  flip one vertex:          delta = gain(v)
+//   N2  flip both ends of an edge: delta = gain(u) + gain(v) - 2w(u,v) if they share a side, + 2w(u,v) if not
+// Pairs without an edge are not scanned: their delta is gain(u) + gain(v), never positive at a
+// 1-flip optimum. After the first full scan N2 only revisits the edges of vertices whose side or
+// gain changed, so a descent costs about the total degree of what it touched.
+// When the descent is stuck, a shake swaps k vertices of X with k of Y (N3), drawn from top-gain
+// lists, i.e. the moves that cost least, and descends again. An improvement is kept and resets k
+// to 1; otherwise the logged flips are rolled back and k grows up to maxShake.
+
+struct VNSConfig {
+    int maxShake = 4;          // most swaps in one shake
+    int maxFailedShakes = 40;  // stop after this many shakes in a row without an improvement
+    int topGain = 32;          // vertices per side in the top-gain lists
+};
+
+struct VNSStats {
+    long long flips = 0, pairMoves = 0, shakes = 0, improvements = 0;
+    size_t peakBytes = 0;  // workspace and search buffers
+};
+
+class VariableNeighbourhoodSearch {
+public:
+    explicit VariableNeighbourhoodSearch(const Graph& g, VNSConfig config = {}) : config(config), queued(g.V + 1, 0), marked(g.V + 1, 0) {
+        worklist.reserve(g.V);
+        dirty.reserve(g.V);
+        flipLog.reserve(g.V);
+        topX.reserve(g.V);
+        topY.reserve(g.V);
+    }
+
+    // Improve the complete partition in ws.side, whose gains must be current, and leave the
+    // result there with its gains current, so it can serve as GRASP's improvement phase
+    VNSStats improve(MaxCutWorkspace& ws, mt19937& rng) {
+        TraceScope trace("vns");
+        stats = VNSStats();
+        withWeights(ws.g, [&](auto weights) { run(ws, rng, weights); });
+        stats.peakBytes = ws.bytes() + bytes();
+        return stats;
+    }
+
+    size_t bytes() const {
+        return vectorBytes(worklist) + vectorBytes(dirty) + vectorBytes(flipLog) + vectorBytes(topX) + vectorBytes(topY) +
+               vectorBytes(queued) + vectorBytes(marked);
+    }
+
+private:
+    VNSConfig config;
+    VNSStats stats;
+    vector<int> worklist;  // N1 candidates
+    vector<int> dirty;     // vertices whose edges N2 has to scan again
+    vector<int> flipLog;   // flips since the shake, for the rollback
+    vector<int> topX, topY;
+    vector<char> queued, marked;
+
+    void touch(int v) {
+        if (!marked[v]) {
+            marked[v] = 1;
+            dirty.push_back(v);
+        }
+    }
+
+    void enqueue(const MaxCutWorkspace& ws, int v) {
+        if (!queued[v] && ws.gain[v] > 0) {
+            queued[v] = 1;
+            worklist.push_back(v);
+        }
+    }
+
+    template <typename Weights>
+    void flip(MaxCutWorkspace& ws, int v, Weights w) {
+        flipVertex(ws, v, w);
+        logFlip(ws, v);
+    }
+
+    // After v flipped: log it, make v and its neighbours N1 candidates (v first, so neighbours go
+    // before a shaken vertex can flip straight back) and have N2 look at their edges again
+    void logFlip(MaxCutWorkspace& ws, int v) {
+        const Graph& g = ws.g;
+        flipLog.push_back(v);
+        stats.flips++;
+        touch(v);
+        enqueue(ws, v);
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int u = g.adjVertex[k];
+            touch(u);
+            enqueue(ws, u);
+        }
+    }
+
+    // Flip both ends of an improving edge from v's list; returns whether one was found
+    template <typename Weights>
+    bool pairMove(MaxCutWorkspace& ws, int v, Weights w) {
+        const Graph& g = ws.g;
+        for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+            int u = g.adjVertex[k];
+            if (u == v) continue;
+            long long delta = ws.gain[v] + ws.gain[u] + (ws.side[u] == ws.side[v] ? -2LL : 2LL) * w[k];
+            if (delta <= 0) continue;
+            // delta is exact unless u and v have parallel edges, so check once v has moved
+            long long before = ws.cutWeight;
+            flipVertex(ws, v, w);
+            if (ws.cutWeight + ws.gain[u] <= before) {
+                flipVertex(ws, v, w);
+                continue;
+            }
+            logFlip(ws, v);
+            flip(ws, u, w);
+            stats.pairMoves++;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Weights>
+    void descend(MaxCutWorkspace& ws, Weights w) {
+        while (true) {
+            // Step 1: N1 until no queued vertex gains
+            while (!worklist.empty()) {
+                int v = worklist.back();
+                worklist.pop_back();
+                queued[v] = 0;
+                if (ws.gain[v] > 0) flip(ws, v, w);
+            }
+
+            // Step 2: N2 over the edges of dirty vertices; a move sends the descent back to N1
+            bool moved = false;
+            while (!moved && !dirty.empty()) {
+                int v = dirty.back();
+                dirty.pop_back();
+                marked[v] = 0;
+                moved = pairMove(ws, v, w);
+            }
+            if (!moved) return;
+        }
+    }
+
+    // The topGain vertices of each side with the highest (least negative) gains
+    void buildTopLists(const MaxCutWorkspace& ws) {
+        topX.clear();
+        topY.clear();
+        for (int v = 1; v <= ws.g.V; v++) (ws.side[v] == 0 ? topX : topY).push_back(v);
+        for (vector<int>* top : {&topX, &topY}) {
+            if ((int)top->size() > config.topGain) {
+                nth_element(top->begin(), top->begin() + config.topGain, top->end(),
+                            [&](int a, int b) { return ws.gain[a] > ws.gain[b]; });
+                top->resize(config.topGain);
+            }
+        }
+    }
+
+    template <typename Weights>
+    void run(MaxCutWorkspace& ws, mt19937& rng, Weights w) {
+        // Step 1: Descend from the given partition, with every vertex a candidate
+        for (int v = 1; v <= ws.g.V; v++) {
+            touch(v);
+            enqueue(ws, v);
+        }
+        descend(ws, w);
+
+        // Step 2: Shake and descend again, keeping only improvements
+        buildTopLists(ws);
+        int k = 1, failed = 0;
+        while (failed < config.maxFailedShakes && !topX.empty() && !topY.empty()) {
+            stats.shakes++;
+            flipLog.clear();
+            long long before = ws.cutWeight;
+            for (int i = 0; i < k; i++) {
+                int u = topX[rng() % topX.size()], v = topY[rng() % topY.size()];
+                if (ws.side[u] == 0) flip(ws, u, w);
+                if (ws.side[v] == 1) flip(ws, v, w);
+            }
+            descend(ws, w);
+
+            if (ws.cutWeight > before) {
+                stats.improvements++;
+                failed = 0;
+                k = 1;
+                buildTopLists(ws);
+            } else {
+                // Rolling back restores the state the top-gain lists were built from
+                for (size_t i = flipLog.size(); i > 0; i--) flipVertex(ws, flipLog[i - 1], w);
+                failed++;
+                k = k % config.maxShake + 1;
+            }
+        }
+    }
+};
+
+// GRASP with VNS instead of plain local search as the improvement phase. VNS draws from rng,
+// so a repeated construction is still searched.
+GRASPStats vnsGRASP(MaxCutWorkspace& ws, int maxIterations, double alpha, mt19937& rng, VNSConfig config = {}, int earlyStopThreshold = 10) {
+    VariableNeighbourhoodSearch vns(ws.g, config);
+    GRASPStats stats = GRASP(ws, maxIterations, alpha, rng, [&](MaxCutWorkspace& w) { vns.improve(w, rng); }, false, earlyStopThreshold);
+    stats.peakBytes += vns.bytes();
+    return stats;
+}
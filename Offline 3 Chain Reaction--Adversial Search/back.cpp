@@ -5,34 +5,181 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <cstdlib>
+#include <iomanip>
 #include <chrono>
 #include <thread>
+#include <array>
+#include <cstdint>
+#include <random>
 using namespace std;
 
-struct Cell {
-    int orbs;
-    char color; // 'R', 'B', or '\0' for empty
+const int MAX_ROWS = 20, MAX_COLS = 20; // the frontend allows up to 20x20
+const int MAX_CELLS = MAX_ROWS * MAX_COLS;
+const int MAX_ORBS = 63;
+// A cascade still going after this many waves is a runaway on a board the mover has filled
+const int MAX_CASCADE_WAVES = 4096;
+const int WIN_SCORE = 1000;
+const int INF = INT_MAX / 2; // search window bound that can be negated safely
+const int CELL_VALUES = 3 << 6; // packed cell bytes, owner code below 3
+const int MAX_SEARCH_DEPTH = 64;
+const int DEFAULT_TIME_BUDGET_MS = 1000;
+
+// One byte per cell: orb count in the low 6 bits, owner in the top 2 (0 none, 1 red, 2 blue).
+// A settled cell holds fewer orbs than its critical mass (at most 4), so MAX_ORBS is never
+// reached in play; a larger count saturates rather than spilling into the owner bits.
+inline int owner_code(char color) {
+    return color == 'R' ? 1 : color == 'B' ? 2 : 0;
+}
+
+inline uint8_t pack_cell(int orbs, char color) {
+    return (uint8_t)(owner_code(color) << 6 | std::min(orbs, MAX_ORBS));
+}
+
+// Previous value of a cell, so a move and its explosions can be undone exactly
+struct CellChange {
+    uint16_t index;
+    uint8_t old_value;
+};
+
+// What one colour holds, kept up to date on every cell write so the win check and the
+// heuristics need no board scan
+struct Material {
+    int orbs = 0;
+    int cells = 0;
+    int corners = 0;        // owned cells with critical mass 2
+    int edges = 0;          // owned cells with critical mass 3
+    int near_critical = 0;  // owned cells at most one orb short of exploding
+};
+
+struct CascadeResult {
+    int length = 0;          // explosions, counting a cell once per time it explodes
+    int waves = 0;           // rounds of simultaneous explosions
+    char eliminated = '\0';  // colour wiped out mid-cascade, after which the cascade stops
+    bool truncated = false;  // stopped at MAX_CASCADE_WAVES
+    bool won = false;        // the mover won during the cascade, by elimination or runaway
+};
+
+enum Bound : uint8_t { BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+struct SearchStats {
+    long long nodes = 0;
+    long long tt_probes = 0, tt_hits = 0, tt_cutoffs = 0;
+    long long expanded = 0;                  // nodes whose moves were searched
+    long long beta_cutoffs = 0, first_move_cutoffs = 0;
+};
+
+// Move ordering ranks: TT move, then moves that explode at once (more for each opponent cell
+// they hit), then the two killers of the ply, then the rest by history score
+const int ORDER_TT_MOVE = 1 << 30;
+const int ORDER_EXPLOSIVE = 1 << 28;
+const int ORDER_KILLER = 1 << 26;
+const int HISTORY_LIMIT = 1 << 24; // history scores are halved before reaching this
+
+// Fixed-size transposition table of minimax results, one entry per slot, deepest result kept
+// unless another position claims the slot. An entry is two words and stores its key XORed with
+// its data, so a torn write from a concurrent writer reads as a miss rather than a wrong hit.
+class TranspositionTable {
+public:
+    struct Entry {
+        int score;
+        int depth;
+        Bound bound;
+        int move; // cell index, -1 if none
+    };
+
+    explicit TranspositionTable(int bits = 20) : slots(size_t(1) << bits), mask((size_t(1) << bits) - 1) {}
+
+    bool probe(uint64_t key, Entry& entry) const {
+        const Slot& slot = slots[key & mask];
+        if ((slot.check ^ slot.data) != key || slot.data == 0) return false;
+        entry.score = (int16_t)(slot.data & 0xFFFF);
+        entry.depth = (slot.data >> 16) & 0xFF;
+        entry.bound = Bound((slot.data >> 24) & 0x3);
+        entry.move = (int)((slot.data >> 32) & 0xFFFF) - 1;
+        return true;
+    }
+
+    void store(uint64_t key, int score, int depth, Bound bound, int move) {
+        Slot& slot = slots[key & mask];
+        bool same = (slot.check ^ slot.data) == key && slot.data != 0;
+        if (same && (int)((slot.data >> 16) & 0xFF) > depth) return;
+        uint64_t data = uint64_t(uint16_t(score)) | uint64_t(depth & 0xFF) << 16 | uint64_t(bound) << 24 |
+                        uint64_t(uint16_t(move + 1)) << 32 | uint64_t(1) << 48; // bit 48 marks the slot used
+        slot.data = data;
+        slot.check = key ^ data;
+    }
+
+    void clear() { std::fill(slots.begin(), slots.end(), Slot()); }
+
+private:
+    struct Slot {
+        uint64_t check = 0; // key ^ data
+        uint64_t data = 0;
+    };
+    std::vector<Slot> slots;
+    size_t mask;
 };
 
 class ChainReaction {
 private:
     int m, n;
-    std::vector<std::vector<Cell>> board;
-    const std::string game_state_file = "gamestate.txt";
-    const int DEPTH_LIMIT = 3;
+    std::array<uint8_t, MAX_CELLS> board{}; // row-major, cell (i, j) at i * n + j
+    std::vector<CellChange> undo_log;       // every cell write since the search started
+    std::array<Material, 3> material{};     // by owner code, kept up to date by set_cell and unmake
+    // Per-cell tables, rebuilt when the board size changes
+    std::array<uint8_t, MAX_CELLS> critical_mass{};
+    std::array<uint8_t, MAX_CELLS> neighbour_count{};
+    std::array<std::array<uint16_t, 4>, MAX_CELLS> neighbours{};
+    // Explosion worklists, reused across cascades
+    std::vector<uint16_t> wave, next_wave;
+    std::array<bool, MAX_CELLS> queued{};
+    std::vector<uint16_t> touched_cells;    // cells changed by the last cascade, for the evaluator
+    std::array<uint32_t, MAX_CELLS> touched_stamp{};
+    uint32_t cascade_stamp = 0;
+    // Zobrist keys: one per (cell, packed cell byte), 0 for an empty cell, and one for blue to move
+    std::vector<uint64_t> zobrist;
+    uint64_t zobrist_blue_to_move = 0;
+    uint64_t board_key = 0; // XOR of the keys of all cells, kept up to date by write_cell
+    TranspositionTable tt;
+    SearchStats stats;
+    std::string game_state_file;
+    // Iterative deepening stops at the per-move time budget: the command-line default, or the
+    // "Time Budget: <ms>" line the game state may carry after its Next Move line, which
+    // write_game_state carries over
+    int default_time_budget_ms;
+    int time_budget_ms;
+    bool time_budget_in_file = false;
+    std::chrono::steady_clock::time_point deadline;
+    std::array<std::array<int, 2>, MAX_SEARCH_DEPTH + 1> killers; // quiet moves that caused a cutoff, per ply
+    std::array<std::array<int, MAX_CELLS>, 3> history{};            // cutoff credit per owner code and cell
+    bool deadline_active = false, search_aborted = false;
     bool is_ai_vs_ai = false;
 
 public:
-    ChainReaction() : m(0), n(0) {
+    explicit ChainReaction(int time_budget_ms = DEFAULT_TIME_BUDGET_MS, const std::string& state_file = "gamestate.txt")
+        : m(0), n(0), game_state_file(state_file), default_time_budget_ms(time_budget_ms), time_budget_ms(time_budget_ms) {
         // Board will be initialized after reading dimensions from file
+        undo_log.reserve(1 << 16);
+        wave.reserve(MAX_CELLS);
+        next_wave.reserve(MAX_CELLS);
+        touched_cells.reserve(MAX_CELLS);
+        std::mt19937_64 rng(20250607);
+        zobrist.assign(MAX_CELLS * CELL_VALUES, 0);
+        for (int c = 0; c < MAX_CELLS; ++c) {
+            for (int value = 1; value < CELL_VALUES; ++value) zobrist[c * CELL_VALUES + value] = rng();
+        }
+        zobrist_blue_to_move = rng();
     }
 
     void run() {
         while (true) {
             if (read_game_state()) {
-                is_ai_vs_ai = is_ai_vs_ai_mode();
+                bool mode = is_ai_vs_ai_mode();
+                if (mode != is_ai_vs_ai) tt.clear(); // stored scores come from the other heuristic
+                is_ai_vs_ai = mode;
                 if (is_ai_vs_ai) {
-                    run_ai_vs_ai();
+                    if (run_ai_vs_ai()) break;
                 } else {
                     auto [best_move_i, best_move_j] = minimax_decision();
                     if (best_move_i == -1 && best_move_j == -1) {
@@ -40,7 +187,7 @@ public:
                         write_game_state("AI Move:", "Human");
                     } else {
                         make_move(best_move_i, best_move_j, 'B');
-                        process_explosions();
+                        process_explosions(best_move_i, best_move_j, true);
                         write_game_state("AI Move:", "Human");
                     }
                     if (check_winner() != '\0') {
@@ -53,6 +200,63 @@ public:
         }
     }
 
+    // Checks of the cell packing, the board parser's orb limits, the cascade and the time budget
+    // line's round trip; writes and removes game_state_file. Returns true if every check passes.
+    bool self_test() {
+        int failures = 0;
+        auto check = [&](bool ok, const char* what) {
+            std::cout << (ok ? "ok     " : "FAILED ") << what << std::endl;
+            if (!ok) ++failures;
+        };
+        auto parses = [&](const std::string& rows) {
+            std::ofstream(game_state_file) << "Board Size: 3 3\nHuman Move:\nNext Move: AI\n" << rows;
+            return read_game_state();
+        };
+
+        check(pack_cell(MAX_ORBS, 'B') >> 6 == owner_code('B') && (pack_cell(MAX_ORBS, 'B') & MAX_ORBS) == MAX_ORBS,
+              "pack_cell keeps MAX_ORBS and the owner");
+        check(pack_cell(MAX_ORBS + 1, 'R') >> 6 == owner_code('R') && (pack_cell(MAX_ORBS + 1, 'R') & MAX_ORBS) == MAX_ORBS,
+              "pack_cell saturates past MAX_ORBS without touching the owner bits");
+        check(parses("1R 2B 1R\n2B 3R 0\n0 0 1B\n"), "parser accepts cells one short of critical mass");
+        check(red().orbs == 5 && blue().orbs == 5 && red().corners == 2 && blue().edges == 2, "counters match the parsed board");
+        check(!parses("2R 0 0\n0 0 0\n0 0 0\n"), "parser rejects a corner at critical mass");
+        check(!parses("0 0 0\n0 4B 0\n0 0 0\n"), "parser rejects an interior cell at critical mass");
+        check(!parses("0 0 0\n0 63R 0\n0 0 0\n"), "parser rejects 63 orbs");
+        check(parses("0 0 0\n0 3R 0\n0 0 1B\n"), "parser accepts an interior cell with 3 orbs");
+        make_move(1, 1, 'R');
+        CascadeResult cascade = process_explosions(1, 1);
+        check(cascade.length == 1 && orbs_at(1, 1) == 0 && orbs_at(0, 1) == 1 && color_at(0, 1) == 'R' && red().orbs == 4,
+              "a fourth orb on that cell explodes once into its neighbours");
+
+        // Red's corner explosion takes blue's last orb and brings (1, 0) to critical mass
+        auto settled = [&]() {
+            for (int c = 0; c < m * n; ++c)
+                if (cell_orbs(c) >= critical_mass[c]) return false;
+            return true;
+        };
+        const std::string eliminating = "1R 1B 0\n2R 0 0\n0 0 0\n";
+        parses(eliminating);
+        make_move(0, 0, 'R');
+        cascade = process_explosions(0, 0);
+        check(cascade.eliminated == 'B' && cascade.won && orbs_at(1, 0) == 3, "search stops the cascade once blue is eliminated");
+        parses(eliminating);
+        make_move(0, 0, 'R');
+        process_explosions(0, 0, true);
+        check(settled() && blue().orbs == 0 && orbs_at(1, 0) == 0, "the game's cascade runs on until the board settles");
+
+        std::ofstream(game_state_file) << "Board Size: 3 3\nHuman Move:\nNext Move: AI\nTime Budget: 50\n1R 0 0\n0 0 0\n0 0 1B\n";
+        read_game_state();
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        minimax_decision('B');
+        check(std::cout.flags() == flags && std::cout.precision() == precision, "the search leaves std::cout's format alone");
+        write_game_state("AI vs AI Move:", "AI Red");
+        time_budget_ms = default_time_budget_ms;
+        check(read_game_state() && time_budget_ms == 50, "the written game state keeps its time budget");
+        std::remove(game_state_file.c_str());
+        return failures == 0;
+    }
+
 private:
     bool is_ai_vs_ai_mode() {
         std::ifstream file(game_state_file);
@@ -68,15 +272,16 @@ private:
         stringstream ss;
         for (int i = 0; i < m; ++i) {
             for (int j = 0; j < n; ++j) {
-                if (board[i][j].orbs == 0) ss << "0 ";
-                else ss << board[i][j].orbs << board[i][j].color << " ";
+                if (orbs_at(i, j) == 0) ss << "0 ";
+                else ss << orbs_at(i, j) << color_at(i, j) << " ";
             }
             ss << "\n";
         }
         return ss.str();
     }
 
-    void run_ai_vs_ai() {
+    // Play both sides until the game ends; true if it ended with a winner
+    bool run_ai_vs_ai() {
         char current_player = 'R'; // Red AI starts
         string prev_board = "";
         int no_progress_count = 0;
@@ -85,13 +290,13 @@ private:
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 continue;
             }
-            if (!is_ai_vs_ai) break; // Exit if mode changes
+            if (!is_ai_vs_ai) return false; // Exit if mode changes
             string curr_board = board_to_string();
             if (curr_board == prev_board) {
                 no_progress_count++;
                 if (no_progress_count >= 2) {
                     std::cerr << "No progress made after 2 attempts, ending AI vs AI game" << std::endl;
-                    break;
+                    return false;
                 }
             } else {
                 no_progress_count = 0;
@@ -101,93 +306,204 @@ private:
             if (best_move_i == -1 && best_move_j == -1) {
                 std::cerr << "No valid moves for AI player " << current_player << std::endl;
                 write_game_state("AI vs AI Move:", current_player == 'R' ? "AI Blue" : "AI Red");
-                if (no_progress_count >= 2) break; // Both players have no moves
+                if (no_progress_count >= 2) return false; // Both players have no moves
                 current_player = (current_player == 'R') ? 'B' : 'R';
                 continue;
             }
             make_move(best_move_i, best_move_j, current_player);
-            process_explosions();
+            process_explosions(best_move_i, best_move_j, true);
             std::cout << "AI " << current_player << " move made at (" << best_move_i << "," << best_move_j << "), board:\n" << board_to_string();
             write_game_state("AI vs AI Move:", current_player == 'R' ? "AI Blue" : "AI Red");
             if (check_winner() != '\0') {
                 std::cout << "Game ended with winner: " << check_winner() << std::endl;
-                break;
+                return true;
             }
             current_player = (current_player == 'R') ? 'B' : 'R';
             std::this_thread::sleep_for(std::chrono::milliseconds(300));
         }
     }
 
+    // Iterative deepening: search 1, 2, 3... plies until the time budget runs out. An iteration cut
+    // short is thrown away and the move from the last completed one is played.
     std::pair<int, int> minimax_decision(char player = 'B') {
-        int best_value = (player == 'B') ? INT_MIN : INT_MAX;
-        std::pair<int, int> best_move = {-1, -1};
-        bool valid_move_found = false;
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (is_valid_move(i, j, player)) {
-                    valid_move_found = true;
-                    auto board_copy = board;
-                    make_move(i, j, player);
-                    process_explosions();
-                    int value = minimax(0, player == 'B' ? false : true, INT_MIN, INT_MAX, player);
-                    board = board_copy;
-                    if (player == 'B' && value > best_value) {
-                        best_value = value;
-                        best_move = {i, j};
-                    } else if (player == 'R' && value < best_value) {
-                        best_value = value;
-                        best_move = {i, j};
-                    }
-                }
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::milliseconds(time_budget_ms);
+        deadline_active = false; // depth 1 always completes, so there is a move to play
+        search_aborted = false;
+        stats = SearchStats();
+        for (auto& ply_killers : killers) ply_killers = {-1, -1};
+        for (auto& side_history : history) {
+            for (int& score : side_history) score /= 2; // older positions count for less
+        }
+        int best_move = -1;
+        // Times and percentages to one decimal, without changing how std::cout formats later output
+        auto one_decimal = [](double value) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << value;
+            return out.str();
+        };
+        for (int depth = 1; depth <= MAX_SEARCH_DEPTH; ++depth) {
+            long long nodes_before = stats.nodes;
+            int move = best_move; // tried first
+            int value = search_root(depth, player, move);
+            double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (search_aborted) {
+                std::cout << "Depth " << depth << ": aborted after " << stats.nodes - nodes_before << " nodes, " << one_decimal(elapsed_ms) << " ms" << std::endl;
+                break;
             }
+            if (move == -1) return {-1, -1}; // no valid move
+            best_move = move;
+            std::cout << "Depth " << depth << ": best (" << move / n << "," << move % n << ") score " << value << ", "
+                      << stats.nodes - nodes_before << " nodes, " << one_decimal(elapsed_ms) << " ms" << std::endl;
+            // A decided game needs no deeper look, and an iteration costs more than all before it
+            if (std::abs(value) == WIN_SCORE || elapsed_ms * 2 > time_budget_ms) break;
+            deadline_active = true;
+        }
+        std::cout << "AI player " << player << " selected move: (" << best_move / n << "," << best_move % n << ")" << std::endl;
+        std::cout << "Search: " << stats.nodes << " nodes, TT " << stats.tt_hits << " hits / " << stats.tt_probes
+                  << " probes, " << stats.tt_cutoffs << " cutoffs" << std::endl;
+        if (stats.expanded > 0 && stats.beta_cutoffs > 0) {
+            std::cout << "Ordering: beta cutoffs at " << one_decimal(100.0 * stats.beta_cutoffs / stats.expanded) << "% of expanded nodes, "
+                      << one_decimal(100.0 * stats.first_move_cutoffs / stats.beta_cutoffs) << "% of them on the first move" << std::endl;
         }
-        if (valid_move_found) {
-            std::cout << "AI player " << player << " selected move: (" << best_move.first << "," << best_move.second << ")" << std::endl;
+        return {best_move / n, best_move % n};
+    }
+
+    // Value of the best of `player`'s moves looking `depth` plies ahead, counting the move itself.
+    // best_move comes in as the previous iteration's choice, searched first, and goes out as this one's.
+    int search_root(int depth, char player, int& best_move) {
+        char opponent = player == 'B' ? 'R' : 'B';
+        int best_value = -INF, alpha = -INF;
+        std::array<int, MAX_CELLS> moves, scores;
+        int count = order_moves(player, best_move, 0, moves, scores);
+        best_move = -1;
+        for (int k = 0; k < count && !search_aborted; ++k) {
+            int c = next_move(k, count, moves, scores);
+            size_t mark = undo_log.size();
+            make_move(c / n, c % n, player);
+            CascadeResult cascade = process_explosions(c / n, c % n);
+            int value = cascade.won ? WIN_SCORE : -minimax(depth - 1, 1, -INF, -alpha, opponent);
+            unmake(mark);
+            if (value > best_value && !search_aborted) {
+                best_value = value;
+                best_move = c;
+            }
+            alpha = std::max(alpha, value);
         }
-        return best_move;
+        return best_value;
     }
 
-    int minimax(int depth, bool is_maximizing, int alpha, int beta, char player = 'B') {
+    // Negamax alpha-beta: the value of the position for `side`, the player to move `ply` plies
+    // below the root, looking `depth` plies ahead. Results are kept in the transposition table
+    // under the position key.
+    int minimax(int depth, int ply, int alpha, int beta, char side) {
+        stats.nodes++;
+        if (deadline_active && (stats.nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) search_aborted = true;
+        if (search_aborted) return 0;
         char winner = check_winner();
-        if (winner == 'B') return (player == 'B') ? 1000 : -1000;
-        if (winner == 'R') return (player == 'R') ? 1000 : -1000;
-        if (depth >= DEPTH_LIMIT) {
-            return is_ai_vs_ai ? evaluate_board_control() : evaluate_critical_cells();
-        }
-
-        char current_player = is_maximizing ? player : (player == 'B' ? 'R' : 'B');
-        if (is_maximizing) {
-            int best_value = INT_MIN;
-            for (int i = 0; i < m; ++i) {
-                for (int j = 0; j < n; ++j) {
-                    if (is_valid_move(i, j, current_player)) {
-                        auto board_copy = board;
-                        make_move(i, j, current_player);
-                        process_explosions();
-                        best_value = std::max(best_value, minimax(depth + 1, false, alpha, beta, player));
-                        board = board_copy;
-                        alpha = std::max(alpha, best_value);
-                        if (beta <= alpha) break;
-                    }
-                }
+        if (winner != '\0') return winner == side ? WIN_SCORE : -WIN_SCORE;
+        if (depth == 0) {
+            int score = is_ai_vs_ai ? evaluate_board_control() : evaluate_critical_cells();
+            return side == 'B' ? score : -score;
+        }
+
+        uint64_t key = board_key ^ (side == 'B' ? zobrist_blue_to_move : 0);
+        TranspositionTable::Entry entry;
+        int tt_move = -1;
+        stats.tt_probes++;
+        if (tt.probe(key, entry)) {
+            stats.tt_hits++;
+            tt_move = entry.move;
+            if (entry.depth >= depth &&
+                (entry.bound == BOUND_EXACT || (entry.bound == BOUND_LOWER && entry.score >= beta) ||
+                 (entry.bound == BOUND_UPPER && entry.score <= alpha))) {
+                stats.tt_cutoffs++;
+                return entry.score;
             }
-            return best_value;
-        } else {
-            int best_value = INT_MAX;
-            for (int i = 0; i < m; ++i) {
-                for (int j = 0; j < n; ++j) {
-                    if (is_valid_move(i, j, current_player)) {
-                        auto board_copy = board;
-                        make_move(i, j, current_player);
-                        process_explosions();
-                        best_value = std::min(best_value, minimax(depth + 1, true, alpha, beta, player));
-                        board = board_copy;
-                        beta = std::min(beta, best_value);
-                        if (beta <= alpha) break;
-                    }
-                }
+        }
+
+        char opponent = side == 'B' ? 'R' : 'B';
+        int original_alpha = alpha;
+        int best_value = -INF, best_move = -1;
+        std::array<int, MAX_CELLS> moves, scores;
+        int count = order_moves(side, tt_move, ply, moves, scores);
+        stats.expanded++;
+        for (int k = 0; k < count && !search_aborted; ++k) {
+            int c = next_move(k, count, moves, scores);
+            size_t mark = undo_log.size();
+            make_move(c / n, c % n, side);
+            CascadeResult cascade = process_explosions(c / n, c % n);
+            int value = cascade.won ? WIN_SCORE : -minimax(depth - 1, ply + 1, -beta, -alpha, opponent);
+            unmake(mark);
+            if (value > best_value) {
+                best_value = value;
+                best_move = c;
+            }
+            alpha = std::max(alpha, value);
+            if (alpha >= beta) {
+                if (!search_aborted) record_cutoff(c, side, depth, ply, scores[k], k);
+                break;
+            }
+        }
+        if (search_aborted) return 0; // partial result, not to be stored
+        if (best_move == -1) return -WIN_SCORE; // no cell left to play on
+
+        Bound bound = best_value <= original_alpha ? BOUND_UPPER : best_value >= beta ? BOUND_LOWER : BOUND_EXACT;
+        tt.store(key, best_value, depth, bound, best_move);
+        return best_value;
+    }
+
+    // Collect side's moves with their ordering scores; returns how many there are
+    int order_moves(char side, int tt_move, int ply, std::array<int, MAX_CELLS>& moves, std::array<int, MAX_CELLS>& scores) {
+        int opponent_code = owner_code(side == 'B' ? 'R' : 'B'), side_code = owner_code(side);
+        int count = 0;
+        for (int c = 0; c < m * n; ++c) {
+            int owner = board[c] >> 6;
+            if (owner != 0 && owner != side_code) continue;
+            int score;
+            if (c == tt_move) {
+                score = ORDER_TT_MOVE;
+            } else if (cell_orbs(c) + 1 >= critical_mass[c]) {
+                score = ORDER_EXPLOSIVE;
+                for (int k = 0; k < neighbour_count[c]; ++k) score += (board[neighbours[c][k]] >> 6) == opponent_code;
+            } else if (c == killers[ply][0] || c == killers[ply][1]) {
+                score = ORDER_KILLER + (c == killers[ply][0]);
+            } else {
+                score = history[side_code][c];
+            }
+            moves[count] = c;
+            scores[count++] = score;
+        }
+        return count;
+    }
+
+    // Move k in order: the best scored of moves k.., swapped into place, so a node cut off
+    // early never sorts the rest
+    int next_move(int k, int count, std::array<int, MAX_CELLS>& moves, std::array<int, MAX_CELLS>& scores) {
+        int best = k;
+        for (int i = k + 1; i < count; ++i) {
+            if (scores[i] > scores[best]) best = i;
+        }
+        std::swap(moves[k], moves[best]);
+        std::swap(scores[k], scores[best]);
+        return moves[k];
+    }
+
+    // Move c, the k-th tried, failed high: count it, and remember a quiet move for this ply and side
+    void record_cutoff(int c, char side, int depth, int ply, int order_score, int k) {
+        stats.beta_cutoffs++;
+        if (k == 0) stats.first_move_cutoffs++;
+        if (order_score >= ORDER_EXPLOSIVE) return; // found early anyway
+        if (killers[ply][0] != c) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = c;
+        }
+        int& score = history[owner_code(side)][c];
+        score += depth * depth;
+        if (score >= HISTORY_LIMIT) {
+            for (auto& side_history : history) {
+                for (int& s : side_history) s /= 2;
             }
-            return best_value;
         }
     }
 
@@ -206,7 +522,7 @@ private:
         }
         std::istringstream size_ss(line.substr(11)); // Skip "Board Size: "
         int new_m, new_n;
-        if (!(size_ss >> new_m >> new_n) || new_m <= 0 || new_n <= 0) {
+        if (!(size_ss >> new_m >> new_n) || new_m <= 0 || new_n <= 0 || new_m > MAX_ROWS || new_n > MAX_COLS) {
             std::cerr << "Invalid board dimensions in " << line << std::endl;
             file.close();
             return false;
@@ -215,7 +531,9 @@ private:
         if (new_m != m || new_n != n) {
             m = new_m;
             n = new_n;
-            board = std::vector<std::vector<Cell>>(m, std::vector<Cell>(n, {0, '\0'}));
+            board.fill(0);
+            build_tables();
+            tt.clear(); // keys are per cell index, which means another cell on a new board
             std::cout << "Initialized backend with board size " << m << "x" << n << std::endl;
         }
         // Read header
@@ -230,10 +548,21 @@ private:
             file.close();
             return false;
         }
-        // Read board
+        // Optional time budget, then the board
+        time_budget_ms = default_time_budget_ms;
+        time_budget_in_file = false;
         std::vector<std::string> lines;
         while (std::getline(file, line)) {
-            if (!line.empty()) lines.push_back(line);
+            if (line.find("Time Budget:") == 0) {
+                std::istringstream budget_ss(line.substr(12));
+                if (!(budget_ss >> time_budget_ms) || time_budget_ms <= 0) {
+                    std::cerr << "Invalid time budget: " << line << std::endl;
+                    return false;
+                }
+                time_budget_in_file = true;
+            } else if (!line.empty()) {
+                lines.push_back(line);
+            }
         }
         file.close();
         // Validate number of rows
@@ -253,19 +582,21 @@ private:
             }
             for (int j = 0; j < n; ++j) {
                 if (cells[j] == "0") {
-                    board[i][j] = {0, '\0'};
+                    board[i * n + j] = 0;
                 } else {
                     try {
                         if (cells[j].size() < 2 || (cells[j].back() != 'R' && cells[j].back() != 'B')) {
                             std::cerr << "Error: Invalid cell format at (" << i << "," << j << "): " << cells[j] << std::endl;
                             return false;
                         }
+                        // A cell at critical mass would have exploded, so a larger count is no game state
                         int orbs = std::stoi(cells[j].substr(0, cells[j].size() - 1));
-                        if (orbs <= 0) {
-                            std::cerr << "Error: Invalid orb count at (" << i << "," << j << "): " << cells[j] << std::endl;
+                        if (orbs <= 0 || orbs >= critical_mass[i * n + j]) {
+                            std::cerr << "Error: Invalid orb count at (" << i << "," << j << "): " << cells[j]
+                                      << ", critical mass " << (int)critical_mass[i * n + j] << std::endl;
                             return false;
                         }
-                        board[i][j] = {orbs, cells[j].back()};
+                        board[i * n + j] = pack_cell(orbs, cells[j].back());
                     } catch (const std::exception& e) {
                         std::cerr << "Error: Failed to parse cell at (" << i << "," << j << "): " << cells[j] << " (" << e.what() << ")" << std::endl;
                         return false;
@@ -273,6 +604,8 @@ private:
                 }
             }
         }
+        recount();
+        undo_log.clear(); // writes to the previous board, including a played move's cascade, cannot be undone
         std::cout << "Successfully read board state from " << game_state_file << std::endl;
         return true;
     }
@@ -282,12 +615,13 @@ private:
         file << "Board Size: " << m << " " << n << "\n";
         file << header << "\n";
         file << "Next Move: " << next_move << "\n";
+        if (time_budget_in_file) file << "Time Budget: " << time_budget_ms << "\n";
         for (int i = 0; i < m; ++i) {
             for (int j = 0; j < n; ++j) {
-                if (board[i][j].orbs == 0) {
+                if (orbs_at(i, j) == 0) {
                     file << "0";
                 } else {
-                    file << board[i][j].orbs << board[i][j].color;
+                    file << orbs_at(i, j) << color_at(i, j);
                 }
                 if (j < n - 1) file << " ";
             }
@@ -299,163 +633,198 @@ private:
 
     // Heuristic 1: Evaluation function 1
     int evaluate() {
-        int blue_orbs = 0, red_orbs = 0;
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (board[i][j].color == 'B') blue_orbs += board[i][j].orbs;
-                if (board[i][j].color == 'R') red_orbs += board[i][j].orbs;
-            }
-        }
-        return blue_orbs - red_orbs;
+        return blue().orbs - red().orbs;
     }
 
     // Heuristic 2: Control of critical cells (corners and edges)
     int evaluate_critical_cells() {
-        int blue_critical = 0, red_critical = 0;
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (board[i][j].color == 'B') {
-                    if (get_critical_mass(i, j) == 2) blue_critical += 5; // Corners
-                    else if (get_critical_mass(i, j) == 3) blue_critical += 3; // Edges
-                } else if (board[i][j].color == 'R') {
-                    if (get_critical_mass(i, j) == 2) red_critical += 5; // Corners
-                    else if (get_critical_mass(i, j) == 3) red_critical += 3; // Edges
-                }
-            }
-        }
+        int blue_critical = 5 * blue().corners + 3 * blue().edges;
+        int red_critical = 5 * red().corners + 3 * red().edges;
         return blue_critical - red_critical;
     }
 
     // Heuristic 3: Explosion potential (proximity to critical mass)
     int evaluate_explosion_potential() {
-        int blue_explosion = 0, red_explosion = 0;
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (board[i][j].orbs > 0) {
-                    int critical = get_critical_mass(i, j);
-                    int closeness = critical - board[i][j].orbs;
-                    if (closeness <= 1 && board[i][j].color == 'B') blue_explosion += 4;
-                    else if (closeness <= 1 && board[i][j].color == 'R') red_explosion += 4;
-                }
-            }
-        }
-        return blue_explosion - red_explosion;
+        return 4 * (blue().near_critical - red().near_critical);
     }
 
     // Heuristic 4: Board control (number of cells occupied) - Used for AI vs AI
     int evaluate_board_control() {
-        int blue_cells = 0, red_cells = 0;
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (board[i][j].color == 'B') blue_cells++;
-                if (board[i][j].color == 'R') red_cells++;
-            }
-        }
-        return blue_cells - red_cells;
+        return blue().cells - red().cells;
     }
 
     // Heuristic 5: Chain reaction length
     int evaluate_chain_length() {
         int blue_chain = 0, red_chain = 0;
-        auto board_copy = board;
         for (int i = 0; i < m; ++i) {
             for (int j = 0; j < n; ++j) {
-                if (board[i][j].orbs > 0 && board[i][j].orbs >= get_critical_mass(i, j)) {
-                    int chain_length = simulate_chain(i, j, board[i][j].color);
-                    if (board[i][j].color == 'B') blue_chain += chain_length;
-                    else if (board[i][j].color == 'R') red_chain += chain_length;
+                if (orbs_at(i, j) > 0 && orbs_at(i, j) >= get_critical_mass(i, j)) {
+                    int chain_length = simulate_chain(i, j);
+                    if (color_at(i, j) == 'B') blue_chain += chain_length;
+                    else if (color_at(i, j) == 'R') red_chain += chain_length;
                 }
             }
         }
-        board = board_copy; // Restore original board
         return blue_chain - red_chain;
     }
 
-    int simulate_chain(int i, int j, char player) {
-        int chain_length = 0;
-        auto temp_board = board;
-        std::vector<std::pair<int, int>> to_explode = {{i, j}};
-        while (!to_explode.empty()) {
-            std::vector<std::pair<int, int>> next_explode;
-            for (auto [x, y] : to_explode) {
-                chain_length++;
-                int critical = get_critical_mass(x, y);
-                temp_board[x][y].orbs -= critical;
-                if (temp_board[x][y].orbs == 0) temp_board[x][y].color = '\0';
-                std::vector<std::pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-                for (auto [di, dj] : directions) {
-                    int ni = x + di, nj = y + dj;
-                    if (ni >= 0 && ni < m && nj >= 0 && nj < n) {
-                        temp_board[ni][nj].orbs += 1;
-                        temp_board[ni][nj].color = player;
-                        if (temp_board[ni][nj].orbs >= get_critical_mass(ni, nj)) {
-                            next_explode.emplace_back(ni, nj);
-                        }
-                    }
-                }
-            }
-            to_explode = next_explode;
-        }
+    int simulate_chain(int i, int j) {
+        size_t mark = undo_log.size();
+        int chain_length = process_explosions(i, j).length;
+        unmake(mark);
         return chain_length;
     }
 
+    int cell_orbs(int c) const { return board[c] & MAX_ORBS; }
+    char cell_color(int c) const { return "\0RB"[board[c] >> 6]; }
+    int orbs_at(int i, int j) const { return cell_orbs(i * n + j); }
+    char color_at(int i, int j) const { return cell_color(i * n + j); }
+
+    // All board changes during search go through here, so unmake can restore them
+    void set_cell(int c, int orbs, char color) {
+        undo_log.push_back({(uint16_t)c, board[c]});
+        write_cell(c, pack_cell(orbs, orbs == 0 ? '\0' : color));
+    }
+
+    // Roll the board back to when undo_log had `mark` entries
+    void unmake(size_t mark) {
+        while (undo_log.size() > mark) {
+            write_cell(undo_log.back().index, undo_log.back().old_value);
+            undo_log.pop_back();
+        }
+    }
+
+    void write_cell(int c, uint8_t value) {
+        count_cell(c, board[c], -1);
+        count_cell(c, value, 1);
+        board_key ^= zobrist[c * CELL_VALUES + board[c]] ^ zobrist[c * CELL_VALUES + value];
+        board[c] = value;
+    }
+
+    // Add (sign 1) or remove (sign -1) cell c holding `value` from its owner's material
+    void count_cell(int c, uint8_t value, int sign) {
+        if ((value >> 6) == 0) return;
+        Material& owned = material[value >> 6];
+        int orbs = value & MAX_ORBS, critical = critical_mass[c];
+        owned.orbs += sign * orbs;
+        owned.cells += sign;
+        owned.corners += sign * (critical == 2);
+        owned.edges += sign * (critical == 3);
+        owned.near_critical += sign * (orbs >= critical - 1);
+    }
+
+    // Rebuild the counters after the board was loaded directly
+    void recount() {
+        material.fill(Material());
+        board_key = 0;
+        for (int c = 0; c < m * n; ++c) {
+            count_cell(c, board[c], 1);
+            board_key ^= zobrist[c * CELL_VALUES + board[c]];
+        }
+    }
+
     bool is_valid_move(int i, int j, char player) {
-        // cout << board[i][j].orbs << " " << board[i][j].color << endl;
-        return board[i][j].color == '\0' || board[i][j].color == player;
+        return color_at(i, j) == '\0' || color_at(i, j) == player;
     }
 
     void make_move(int i, int j, char player) {
-        board[i][j].orbs += 1;
-        board[i][j].color = player;
+        set_cell(i * n + j, orbs_at(i, j) + 1, player);
     }
 
-    void process_explosions() {
-        while (true) {
-            std::vector<std::pair<int, int>> explosions;
-            for (int i = 0; i < m; ++i) {
-                for (int j = 0; j < n; ++j) {
-                    if (board[i][j].orbs >= get_critical_mass(i, j)) {
-                        explosions.emplace_back(i, j);
-                    }
-                }
+    // Resolve the explosions set off by the orb just placed at (i, j). Only cells that reached
+    // critical mass are visited: each wave explodes the cells that went critical in the one
+    // before, as the old full-board rescans did, and the final board is the same since it does not
+    // depend on the order of explosions. In search it stops early once the mover's opponent has no
+    // orbs left, since the position is won whatever is still critical; with settle it runs on so
+    // the board the game writes out has no cell at critical mass.
+    // A cascade that never settles must keep every cell exploding, and so would capture every
+    // opponent orb; one still running after MAX_CASCADE_WAVES is stopped and counted as a win.
+    // That is the one board left unsettled, and it ends the game.
+    CascadeResult process_explosions(int i, int j, bool settle = false) {
+        CascadeResult result;
+        touched_cells.clear();
+        ++cascade_stamp;
+        int start = i * n + j;
+        if (orbs_at(i, j) < critical_mass[start]) return result;
+
+        char player = color_at(i, j), opponent = player == 'R' ? 'B' : 'R';
+        const int& opponent_orbs = material[owner_code(opponent)].orbs;
+        bool opponent_present = opponent_orbs > 0;
+
+        wave.assign(1, start);
+        queued[start] = true;
+        while (!wave.empty() && result.eliminated == '\0') {
+            if (result.waves == MAX_CASCADE_WAVES) {
+                result.truncated = true;
+                break;
             }
-            if (explosions.empty()) break;
-            for (auto [i, j] : explosions) {
-                explode_cell(i, j);
+            result.waves++;
+            next_wave.clear();
+            for (uint16_t c : wave) {
+                queued[c] = false;
+                int critical = critical_mass[c];
+                result.length++;
+                touch(c);
+                set_cell(c, cell_orbs(c) - critical, player);
+                if (cell_orbs(c) >= critical) push_next(c);
+                for (int k = 0; k < neighbour_count[c]; ++k) {
+                    int nb = neighbours[c][k];
+                    touch(nb);
+                    set_cell(nb, cell_orbs(nb) + 1, player);
+                    if (cell_orbs(nb) >= critical_mass[nb]) push_next(nb);
+                }
+                if (!settle && opponent_present && opponent_orbs == 0) {
+                    result.eliminated = opponent;
+                    break;
+                }
             }
+            wave.swap(next_wave);
         }
+        for (uint16_t c : wave) queued[c] = false;
+        for (uint16_t c : next_wave) queued[c] = false;
+        result.won = result.eliminated != '\0' || result.truncated;
+        return result;
     }
 
-    int get_critical_mass(int i, int j) {
-        if ((i == 0 || i == m - 1) && (j == 0 || j == n - 1)) return 2;
-        if (i == 0 || i == m - 1 || j == 0 || j == n - 1) return 3;
-        return 4;
-    }
-
-    void explode_cell(int i, int j) {
-        int critical_mass = get_critical_mass(i, j);
-        char player = board[i][j].color;
-        board[i][j].orbs -= critical_mass;
-        if (board[i][j].orbs == 0) board[i][j].color = '\0';
-        std::vector<std::pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-        for (auto [di, dj] : directions) {
-            int ni = i + di, nj = j + dj;
-            if (ni >= 0 && ni < m && nj >= 0 && nj < n) {
-                board[ni][nj].orbs += 1;
-                board[ni][nj].color = player;
-                // std::cout << "Exploded (" << i << "," << j << ") -> Adjacent (" << ni << "," << nj << ") set to " << player << " with " << board[ni][nj].orbs << " orbs" << std::endl;
-            }
+    void push_next(int c) {
+        if (!queued[c]) {
+            queued[c] = true;
+            next_wave.push_back(c);
         }
     }
 
-    char check_winner() {
-        int red_count = 0, blue_count = 0;
+    void touch(int c) {
+        if (touched_stamp[c] != cascade_stamp) {
+            touched_stamp[c] = cascade_stamp;
+            touched_cells.push_back(c);
+        }
+    }
+
+    void build_tables() {
         for (int i = 0; i < m; ++i) {
             for (int j = 0; j < n; ++j) {
-                if (board[i][j].color == 'R' && board[i][j].orbs > 0) red_count += board[i][j].orbs;
-                if (board[i][j].color == 'B' && board[i][j].orbs > 0) blue_count += board[i][j].orbs;
+                int c = i * n + j, count = 0;
+                if (i > 0) neighbours[c][count++] = c - n;
+                if (i < m - 1) neighbours[c][count++] = c + n;
+                if (j > 0) neighbours[c][count++] = c - 1;
+                if (j < n - 1) neighbours[c][count++] = c + 1;
+                neighbour_count[c] = count;
+                // Corners 2, edges 3, interior 4, also on boards one cell wide
+                bool row_edge = i == 0 || i == m - 1, col_edge = j == 0 || j == n - 1;
+                critical_mass[c] = row_edge && col_edge ? 2 : row_edge || col_edge ? 3 : 4;
             }
         }
+    }
+
+    int get_critical_mass(int i, int j) {
+        return critical_mass[i * n + j];
+    }
+
+    const Material& red() const { return material[owner_code('R')]; }
+    const Material& blue() const { return material[owner_code('B')]; }
+
+    char check_winner() {
+        int red_count = red().orbs, blue_count = blue().orbs;
         int total_moves = red_count + blue_count;
         if (total_moves < 2) return '\0';
         if (red_count == 0 && blue_count > 0) return 'B';
@@ -464,8 +833,19 @@ private:
     }
 };
 
-int main() {
-    ChainReaction game;
+// Usage: back [time-budget-ms], the search time per AI move (default 1000)
+//        back --self-test, runs the built-in checks and exits 1 if any fails
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--self-test") {
+        ChainReaction game(DEFAULT_TIME_BUDGET_MS, "selftest_gamestate.txt");
+        return game.self_test() ? 0 : 1;
+    }
+    int time_budget_ms = argc > 1 ? std::atoi(argv[1]) : DEFAULT_TIME_BUDGET_MS;
+    if (time_budget_ms <= 0) {
+        std::cerr << "Invalid time budget: " << argv[1] << std::endl;
+        return 1;
+    }
+    ChainReaction game(time_budget_ms);
     game.run();
     return 0;
 }
\ No newline at end of file
@@ -193,7 +193,8 @@ class ChainReactionUI:
                     if header != "AI vs AI Move:" or next_move not in ["Next Move: AI Red", "Next Move: AI Blue"]:
                         print(f"Error: Expected 'AI vs AI Move:' and 'Next Move: AI Red/Blue', got {header}, {next_move}")
                         return False
-                board_lines = lines[3:]
+                # The backend writes back an optional "Time Budget: <ms>" line before the board
+                board_lines = [line for line in lines[3:] if not line.startswith("Time Budget:")]
                 if len(board_lines) != self.m:
                     print(f"Error: Expected {self.m} rows in {self.game_state_file}, got {len(board_lines)}")
                     return False